@@ -245,10 +245,18 @@ namespace Ribosoft.Jobs
                 return;
             }
 
+            using var modelContext = await CreateModelContext(job);
+            if (modelContext == null)
+            {
+                return;
+            }
+
             CandidateGeneration.CandidateGenerator candidateGenerator = new CandidateGeneration.CandidateGenerator();
             foreach (var rnaInput in rnaInputs)
             {
-                RNAStructure = _ribosoftAlgo.MFEFold(rnaInput);
+                RNAStructure = _ribosoftAlgo.MFEFold(rnaInput, modelContext);
+                using var pairingIndex = _ribosoftAlgo.CreatePairingIndex(RNAStructure);
+                using var targetContext = _ribosoftAlgo.CreateTargetContext(rnaInput);
 
                 foreach (var ribozymeStructure in job.Ribozyme.RibozymeStructures)
                 {
@@ -282,7 +290,7 @@ namespace Ribosoft.Jobs
                         foreach (var candidate in candidates)
                         {
                             cancellationToken.ThrowIfCancellationRequested();
-                            RunScoreAlgorithms(candidate, job, ribozymeStructure, RNAStructure);
+                            RunScoreAlgorithms(candidate, job, ribozymeStructure, targetContext, pairingIndex, modelContext);
 
                             if (++batchCount % 100 == 0)
                             {
@@ -336,6 +344,28 @@ namespace Ribosoft.Jobs
             await _db.SaveChangesAsync();
         }
 
+        /*! \fn CreateModelContext
+         * \brief Helper function to set the folding and annealing conditions of the job once
+         * The job is marked as errored if its conditions are out of range
+         * \param job Current job
+         * \return modelContext Model context of the job, or null if errored
+         */
+        private async Task<RibosoftAlgo.ModelContext?> CreateModelContext(Job job)
+        {
+            try
+            {
+                return _ribosoftAlgo.CreateModelContext(job.TargetTemperature.GetValueOrDefault(), job.Na.GetValueOrDefault(), job.Probe.GetValueOrDefault());
+            }
+            catch (RibosoftAlgoException e)
+            {
+                job.JobState = JobState.Errored;
+                job.StatusMessage = e.Code.ToString();
+                _logger.LogError(e, "Exception occurred during Ribosoft Algorithms.");
+                await _db.SaveChangesAsync();
+                return null;
+            }
+        }
+
         /*! \fn SetTargetRegions
          * \brief Helper function to set the target regions for the job
          * \param job Current job
@@ -379,23 +409,34 @@ namespace Ribosoft.Jobs
          * \param candidate Current candidate
          * \param job Current job
          * \param ribozymeStructure Current ribozyme structure
+         * \param targetContext Target context of the RNA input
+         * \param pairingIndex Pairing index of the structure of the RNA input
+         * \param modelContext Model context of the job
          */
-        private void RunScoreAlgorithms(Candidate candidate, Job job, RibozymeStructure ribozymeStructure, string RNAStructure)
+        private void RunScoreAlgorithms(Candidate candidate, Job job, RibozymeStructure ribozymeStructure, RibosoftAlgo.TargetContext targetContext, RibosoftAlgo.PairingIndex pairingIndex, RibosoftAlgo.ModelContext modelContext)
         {
             var idealStructurePattern = new Regex(@"[^.^(^)]");
             string ideal = idealStructurePattern.Replace(candidate.Structure ?? string.Empty, ".");
 
-            float naConcentration = job.Na.GetValueOrDefault();
-            float probeConcentration = job.Probe.GetValueOrDefault();
-            float targetTemperature = job.TargetTemperature.GetValueOrDefault();
-
-            var temperatureScore = _ribosoftAlgo.Anneal(candidate, candidate.SubstrateSequence ?? string.Empty,
-                candidate.SubstrateStructure ?? string.Empty, naConcentration, probeConcentration, targetTemperature);
+            var cutsiteIndices = candidate.CutsiteIndices ?? new List<int>();
+            float temperatureScore;
+            float[] accessibilityScores;
+            if (cutsiteIndices.Count > 0)
+            {
+                // the substrate is read in place on the target at its first cutsite
+                accessibilityScores = _ribosoftAlgo.CandidateScore(candidate, targetContext, pairingIndex, cutsiteIndices,
+                    modelContext, out temperatureScore);
+            }
+            else
+            {
+                accessibilityScores = _ribosoftAlgo.CandidateScore(candidate, pairingIndex, cutsiteIndices,
+                    modelContext, out temperatureScore);
+            }
 
-            foreach (var cutsiteIndex in candidate.CutsiteIndices ?? new List<int>())
+            for (int i = 0; i < cutsiteIndices.Count; ++i)
             {
-                var accessibilityScore = _ribosoftAlgo.Accessibility(candidate, RNAStructure,
-                    cutsiteIndex, naConcentration, probeConcentration, targetTemperature);
+                var cutsiteIndex = cutsiteIndices[i];
+                var accessibilityScore = accessibilityScores[i];
 
                 _db.Designs.Add(new Design
                 {
@@ -424,11 +465,17 @@ namespace Ribosoft.Jobs
          */
         private async Task CalculateStructure(Job job, IJobCancellationToken cancellationToken)
         {
+            using var modelContext = await CreateModelContext(job);
+            if (modelContext == null)
+            {
+                return;
+            }
+
             IList<Design> designs = _db.Designs
                              .Where(d => d.JobId == job.Id)
                              .ToList();
 
-            _ribosoftAlgo.Structure(designs);
+            _ribosoftAlgo.Structure(designs, modelContext);
 
             _db.Jobs.Attach(job);
             await _db.SaveChangesAsync();
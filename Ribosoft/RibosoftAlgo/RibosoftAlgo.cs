@@ -25,11 +25,48 @@ namespace Ribosoft
         public float Probability;
     }
 
+    /*! \struct FoldArena
+     * \brief Fold structures as columns, mirroring the native fold_arena
+     */
+    [StructLayout(LayoutKind.Sequential, Pack = 8)]
+    internal struct FoldArena
+    {
+        /*! \property Count
+         * \brief Number of structures
+         */
+        public UIntPtr Count;
+
+        /*! \property Stride
+         * \brief Characters per structure, including the null terminator
+         */
+        public UIntPtr Stride;
+
+        /*! \property Probabilities
+         * \brief Pointer to the probability of each structure
+         */
+        public IntPtr Probabilities;
+
+        /*! \property Energies
+         * \brief Pointer to the free energy of each structure
+         */
+        public IntPtr Energies;
+
+        /*! \property Structures
+         * \brief Pointer to the structures, one every Stride characters
+         */
+        public IntPtr Structures;
+    }
+
     /*! \class RibosoftAlgo
      * \brief Wrapper class to import dll functionality from RibosoftAlgo nuget package
      */
     public class RibosoftAlgo
     {
+        /*! \var FoldBatchSize
+         * \brief Number of designs folded per native batch call
+         */
+        private const int FoldBatchSize = 1024;
+
         /*! \fn validate_sequence
          * \brief DllImport from RibosoftAlgo of validate_sequence
          * \param sequence Sequence being validated
@@ -46,6 +83,15 @@ namespace Ribosoft
         [DllImport("RibosoftAlgo")]
         private static extern R_STATUS validate_structure(string structure);
 
+        /*! \fn validate_sequence_view
+         * \brief DllImport from RibosoftAlgo of validate_sequence_view
+         * \param sequence First UTF-8 byte of the sequence being validated
+         * \param length Length of the sequence
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS validate_sequence_view(ref byte sequence, UIntPtr length);
+
         /*! \fn accessibility
          * \brief DllImport from RibosoftAlgo of accessibility
          * \param substrateSequence Sequence of the substrate
@@ -59,6 +105,151 @@ namespace Ribosoft
         [DllImport("RibosoftAlgo")]
         private static extern R_STATUS accessibility(string substrateSequence, string substrateStructure, string foldedStructure, float na_concentration, float probe_concentration, float targetTemperature, out float score);
 
+        /*! \fn candidate_score
+         * \brief DllImport from RibosoftAlgo of candidate_score
+         * \param context Pointer to the model context of the job, or IntPtr.Zero for the default model
+         * \param substrateSequence Sequence of the substrate
+         * \param substrateStructure Structure of the substrate
+         * \param rnaStructure Structure of the folded RNA
+         * \param cutsiteIndices Cutsite indices on the RNA
+         * \param cutsiteCount Number of cutsite indices
+         * \param na_concentration Concentration of sodium
+         * \param probe_concentration Concentration of probe
+         * \param targetTemperature Target temperature of binding arms
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \param accessibilityScores Out array of the accessibility scores, one per cutsite index
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS candidate_score(IntPtr context, string substrateSequence, string substrateStructure, string rnaStructure, int[] cutsiteIndices, UIntPtr cutsiteCount, float na_concentration, float probe_concentration, float targetTemperature, out float temperatureScore, [Out] float[] accessibilityScores);
+
+        /*! \fn candidate_score_indexed
+         * \brief DllImport from RibosoftAlgo of candidate_score_indexed
+         * \param context Pointer to the model context of the job, or IntPtr.Zero for the default model
+         * \param substrateSequence Sequence of the substrate
+         * \param substrateStructure Structure of the substrate
+         * \param index Pairing index of the folded RNA
+         * \param cutsiteIndices Cutsite indices on the RNA
+         * \param cutsiteCount Number of cutsite indices
+         * \param na_concentration Concentration of sodium
+         * \param probe_concentration Concentration of probe
+         * \param targetTemperature Target temperature of binding arms
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \param accessibilityScores Out array of the accessibility scores, one per cutsite index
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS candidate_score_indexed(IntPtr context, string substrateSequence, string substrateStructure, IntPtr index, int[] cutsiteIndices, UIntPtr cutsiteCount, float na_concentration, float probe_concentration, float targetTemperature, out float temperatureScore, [Out] float[] accessibilityScores);
+
+        /*! \fn candidate_score_indexed_view
+         * \brief DllImport from RibosoftAlgo of candidate_score_indexed_view
+         * \param context Pointer to the model context of the job, or IntPtr.Zero for the default model
+         * \param substrateSequence First UTF-8 byte of the sequence of the substrate
+         * \param sequenceLength Length of the sequence of the substrate
+         * \param substrateStructure First UTF-8 byte of the structure of the substrate
+         * \param structureLength Length of the structure of the substrate
+         * \param index Pairing index of the folded RNA
+         * \param cutsiteIndices Cutsites on the RNA (beginning of substrate sequence)
+         * \param cutsiteCount Number of cutsites
+         * \param na_concentration Concentration of sodium
+         * \param probe_concentration Concentration of probe
+         * \param targetTemperature Target temperature of binding arms
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \param accessibilityScores Out parameter for the accessibility score at each cutsite
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS candidate_score_indexed_view(IntPtr context, ref byte substrateSequence, UIntPtr sequenceLength, ref byte substrateStructure, UIntPtr structureLength, IntPtr index, int[] cutsiteIndices, UIntPtr cutsiteCount, float na_concentration, float probe_concentration, float targetTemperature, out float temperatureScore, [Out] float[] accessibilityScores);
+
+        /*! \fn pairing_index_create
+         * \brief DllImport from RibosoftAlgo of pairing_index_create
+         * \param foldedStructure Structure of the folded RNA
+         * \param index Out pointer to the pairing index
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS pairing_index_create(string foldedStructure, out IntPtr index);
+
+        /*! \fn pairing_index_free
+         * \brief DllImport from RibosoftAlgo of pairing_index_free
+         * \param index Pointer to the pairing index
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern void pairing_index_free(IntPtr index);
+
+        /*! \fn target_context_create
+         * \brief DllImport from RibosoftAlgo of target_context_create
+         * \param rna Sequence of the target RNA
+         * \param context Out pointer to the target context
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS target_context_create(string rna, out IntPtr context);
+
+        /*! \fn target_context_free
+         * \brief DllImport from RibosoftAlgo of target_context_free
+         * \param context Pointer to the target context
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern void target_context_free(IntPtr context);
+
+        /*! \fn target_context_candidate_score
+         * \brief DllImport from RibosoftAlgo of target_context_candidate_score
+         * \param context Pointer to the model context of the job, or IntPtr.Zero to use the next three arguments
+         * \param target Pointer to the target context of the RNA
+         * \param substrateStructure Structure of the substrate
+         * \param index Pairing index of the folded RNA
+         * \param cutsiteIndices Cutsite indices on the RNA
+         * \param cutsiteCount Number of cutsite indices
+         * \param na_concentration Concentration of sodium
+         * \param probe_concentration Concentration of probe
+         * \param targetTemperature Target temperature of binding arms
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \param accessibilityScores Out array of the accessibility scores, one per cutsite index
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS target_context_candidate_score(IntPtr context, IntPtr target, string substrateStructure, IntPtr index, int[] cutsiteIndices, UIntPtr cutsiteCount, float na_concentration, float probe_concentration, float targetTemperature, out float temperatureScore, [Out] float[] accessibilityScores);
+
+        /*! \fn candidate_score_profiled
+         * \brief DllImport from RibosoftAlgo of candidate_score_profiled
+         * \param context Pointer to the model context of the job, or IntPtr.Zero for the default model
+         * \param substrateSequence Sequence of the substrate
+         * \param substrateStructure Structure of the substrate
+         * \param profile Unpaired profile of the RNA
+         * \param cutsiteIndices Cutsite indices on the RNA
+         * \param cutsiteCount Number of cutsite indices
+         * \param na_concentration Concentration of sodium
+         * \param probe_concentration Concentration of probe
+         * \param targetTemperature Target temperature of binding arms
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \param accessibilityScores Out array of the accessibility scores, one per cutsite index
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS candidate_score_profiled(IntPtr context, string substrateSequence, string substrateStructure, IntPtr profile, int[] cutsiteIndices, UIntPtr cutsiteCount, float na_concentration, float probe_concentration, float targetTemperature, out float temperatureScore, [Out] float[] accessibilityScores);
+
+        /*! \fn unpaired_profile_create
+         * \brief DllImport from RibosoftAlgo of unpaired_profile_create
+         * \param context Pointer to the model context of the job, or IntPtr.Zero for the default model
+         * \param rnaSequence Sequence of the RNA
+         * \param stretchLengths Stretch lengths to profile
+         * \param count Number of stretch lengths
+         * \param windowSize Size of the sliding window (0 for the whole RNA)
+         * \param maxBasePairSpan Maximum span of a base pair (0 for the window size)
+         * \param profile Out pointer to the unpaired profile
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS unpaired_profile_create(IntPtr context, string rnaSequence, int[] stretchLengths, UIntPtr count, int windowSize, int maxBasePairSpan, out IntPtr profile);
+
+        /*! \fn unpaired_profile_free
+         * \brief DllImport from RibosoftAlgo of unpaired_profile_free
+         * \param profile Pointer to the unpaired profile
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern void unpaired_profile_free(IntPtr profile);
+
         /*! \fn anneal
          * \brief DllImport from RibosoftAlgo of anneal
          * \param sequence RNA sequence
@@ -72,23 +263,45 @@ namespace Ribosoft
         [DllImport("RibosoftAlgo")]
         private static extern R_STATUS anneal(string sequence, string structure, float na_concentration, float probe_concentration, float target_temp, out float temp);
 
-        /*! \fn fold
-         * \brief DllImport from RibosoftAlgo of fold
+        /*! \fn fold_arena_create
+         * \brief DllImport from RibosoftAlgo of fold_arena_create
+         * \param context Pointer to the model context of the job, or IntPtr.Zero for the default model
          * \param sequence RNA sequence
-         * \param output Output pointer to the list of fold outputs
-         * \param size Out value of the size of the list
+         * \param arena Output pointer to the fold columns
          * \return status Status code
          */
         [DllImport("RibosoftAlgo")]
-        private static extern R_STATUS fold(string sequence, out IntPtr output, out int size);
+        private static extern R_STATUS fold_arena_create(IntPtr context, string sequence, out IntPtr arena);
 
-        /*! \fn fold_output_free
-         * \brief DllImport from RibosoftAlgo of fold_output_free
-         * \param output Pointer to fold output list
-         * \param size Size of the list
+        /*! \fn fold_arena_free
+         * \brief DllImport from RibosoftAlgo of fold_arena_free
+         * \param arena Pointer to the fold columns
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern void fold_arena_free(IntPtr arena);
+
+        /*! \fn fold_batch
+         * \brief DllImport from RibosoftAlgo of fold_batch
+         * \param context Pointer to the model context of the job, or IntPtr.Zero for the default model
+         * \param sequences RNA sequences
+         * \param count Number of sequences
+         * \param threadCount Number of native threads (0 for all cores)
+         * \param outputs Out array of pointers to the lists of fold outputs
+         * \param sizes Out array of the sizes of the lists
+         * \param statuses Out array of status codes
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS fold_batch(IntPtr context, string[] sequences, UIntPtr count, int threadCount, [Out] IntPtr[] outputs, [Out] UIntPtr[] sizes, [Out] R_STATUS[] statuses);
+
+        /*! \fn fold_batch_free
+         * \brief DllImport from RibosoftAlgo of fold_batch_free
+         * \param outputs Pointers to the fold output lists
+         * \param sizes Sizes of the lists
+         * \param count Number of lists
          */
         [DllImport("RibosoftAlgo")]
-        private static extern void fold_output_free(IntPtr output, int size);
+        private static extern void fold_batch_free(IntPtr[] outputs, UIntPtr[] sizes, UIntPtr count);
 
         /*! \fn default_fold
          * \brief DllImport from RibosoftAlgo of mfe_default_fold
@@ -99,6 +312,46 @@ namespace Ribosoft
         [DllImport("RibosoftAlgo")]
         private static extern R_STATUS mfe_default_fold(string sequence, out IntPtr structure);
 
+        /*! \fn mfe_default_fold_view
+         * \brief DllImport from RibosoftAlgo of mfe_default_fold_view
+         * \param sequence First UTF-8 byte of the sequence to be folded
+         * \param length Length of the sequence
+         * \param structure Output pointer to the folded structure
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS mfe_default_fold_view(ref byte sequence, UIntPtr length, out IntPtr structure);
+
+        /*! \fn mfe_fold_with_context
+         * \brief DllImport from RibosoftAlgo of mfe_fold_with_context
+         * \param context Pointer to the model context
+         * \param sequence Sequence to be folded
+         * \param structure Output pointer to the folded structure
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS mfe_fold_with_context(IntPtr context, string sequence, out IntPtr structure);
+
+        /*! \fn model_context_create
+         * \brief DllImport from RibosoftAlgo of model_context_create
+         * \param temperature Target temperature
+         * \param dangles Dangling end model
+         * \param maxBasePairSpan Maximum span of a base pair (-1 for no maximum)
+         * \param naConcentration Sodium (Na+) concentration
+         * \param probeConcentration Nucleic acid concentration in excess
+         * \param context Output pointer to the model context
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS model_context_create(float temperature, int dangles, int maxBasePairSpan, float naConcentration, float probeConcentration, out IntPtr context);
+
+        /*! \fn model_context_free
+         * \brief DllImport from RibosoftAlgo of model_context_free
+         * \param context Pointer to the model context
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern void model_context_free(IntPtr context);
+
         /*! \fn fold_output_free
          * \brief DllImport from RibosoftAlgo of mfe_default_fold_free
          * \param output Pointer to fold output list
@@ -116,6 +369,22 @@ namespace Ribosoft
         [DllImport("RibosoftAlgo")]
         private static extern R_STATUS structure(string candidate, string ideal, out float distance);
 
+        /*! \fn structure_score_batch
+         * \brief DllImport from RibosoftAlgo of structure_score_batch
+         * \param context Pointer to the model context of the job, or IntPtr.Zero for the default model
+         * \param sequences Design sequences
+         * \param ideals Ideal structures
+         * \param count Number of designs
+         * \param threadCount Number of native threads (0 for all cores)
+         * \param weightedDistances Out array of probability-weighted distances
+         * \param maxDistances Out array of maximum distances
+         * \param probabilities Out array of summed probabilities
+         * \param statuses Out array of status codes
+         * \return status Status code
+         */
+        [DllImport("RibosoftAlgo")]
+        private static extern R_STATUS structure_score_batch(IntPtr context, string[] sequences, string[] ideals, UIntPtr count, int threadCount, [Out] float[] weightedDistances, [Out] float[] maxDistances, [Out] float[] probabilities, [Out] R_STATUS[] statuses);
+
         /*!
          * \brief Default constructor
          */
@@ -143,6 +412,17 @@ namespace Ribosoft
             return validate_structure(structure);
         }
 
+        /*! \fn ValidateSequence
+         * \brief Algorithm function to validate a UTF-8 sequence in place, without
+         * converting it to a string (for example a range of the input RNA)
+         * \param sequence UTF-8 bytes of the sequence being validated
+         * \return status Status code
+         */
+        public R_STATUS ValidateSequence(ReadOnlySpan<byte> sequence)
+        {
+            return validate_sequence_view(ref MemoryMarshal.GetReference(sequence), new UIntPtr((uint)sequence.Length));
+        }
+
         /*! \fn Accessibility
          * \brief Algorithm function to determine the accessibility of the cutsite on the input RNA 
          * with this particular candidate sequence and cutsite
@@ -168,6 +448,236 @@ namespace Ribosoft
             return score;
         }
 
+        /*! \fn CandidateScore
+         * \brief Algorithm function to determine, in one call, the annealing temperature of this
+         * particular candidate and the accessibility of each of its cutsites on the input RNA
+         * \param candidate Candidate being evaluated
+         * \param rnaStructure structure of input RNA
+         * \param cutsiteIndices Cutsites on RNA input (beginning of substrate sequence)
+         * \param naConcentration Concentration of sodium
+         * \param probeConcentration Concentration of probe
+         * \param targetTemperature Target temperature of binding arms
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \return accessibilityScores Float evaluation score values, one per cutsite index
+         */
+        public float[] CandidateScore(Candidate candidate, string rnaStructure, IList<int> cutsiteIndices, float naConcentration, float probeConcentration, float targetTemperature, out float temperatureScore)
+        {
+            var indices = cutsiteIndices.ToArray();
+            var accessibilityScores = new float[indices.Length];
+
+            R_STATUS status = candidate_score(IntPtr.Zero, candidate.SubstrateSequence ?? "", candidate.SubstrateStructure ?? "", rnaStructure ?? "",
+                indices, new UIntPtr((uint)indices.Length), naConcentration, probeConcentration, targetTemperature, out temperatureScore, accessibilityScores);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return accessibilityScores;
+        }
+
+        /*! \fn CandidateScore
+         * \brief Algorithm function to determine, in one call, the annealing temperature of this
+         * particular candidate and the accessibility of each of its cutsites on an indexed input RNA
+         * \param candidate Candidate being evaluated
+         * \param pairingIndex Pairing index of the structure of input RNA
+         * \param cutsiteIndices Cutsites on RNA input (beginning of substrate sequence)
+         * \param naConcentration Concentration of sodium
+         * \param probeConcentration Concentration of probe
+         * \param targetTemperature Target temperature of binding arms
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \return accessibilityScores Float evaluation score values, one per cutsite index
+         */
+        public float[] CandidateScore(Candidate candidate, PairingIndex pairingIndex, IList<int> cutsiteIndices, float naConcentration, float probeConcentration, float targetTemperature, out float temperatureScore)
+        {
+            var indices = cutsiteIndices.ToArray();
+            var accessibilityScores = new float[indices.Length];
+
+            R_STATUS status = candidate_score_indexed(IntPtr.Zero, candidate.SubstrateSequence ?? "", candidate.SubstrateStructure ?? "", pairingIndex.Handle,
+                indices, new UIntPtr((uint)indices.Length), naConcentration, probeConcentration, targetTemperature, out temperatureScore, accessibilityScores);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return accessibilityScores;
+        }
+
+        /*! \fn CandidateScore
+         * \brief Algorithm function to determine, in one call, the annealing temperature of this
+         * particular candidate and the accessibility of each of its cutsites on an indexed input RNA,
+         * at the concentrations and target temperature of a model context
+         * \param candidate Candidate being evaluated
+         * \param pairingIndex Pairing index of the structure of input RNA
+         * \param cutsiteIndices Cutsites on RNA input (beginning of substrate sequence)
+         * \param context Model context of the job
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \return accessibilityScores Float evaluation score values, one per cutsite index
+         */
+        public float[] CandidateScore(Candidate candidate, PairingIndex pairingIndex, IList<int> cutsiteIndices, ModelContext context, out float temperatureScore)
+        {
+            var indices = cutsiteIndices.ToArray();
+            var accessibilityScores = new float[indices.Length];
+
+            R_STATUS status = candidate_score_indexed(context.Handle, candidate.SubstrateSequence ?? "", candidate.SubstrateStructure ?? "", pairingIndex.Handle,
+                indices, new UIntPtr((uint)indices.Length), 0.0f, 0.0f, 0.0f, out temperatureScore, accessibilityScores);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return accessibilityScores;
+        }
+
+        /*! \fn CandidateScore
+         * \brief Algorithm function to determine, in one call, the annealing temperature of this
+         * particular candidate and the accessibility of each of its cutsites on an indexed input RNA,
+         * with the substrate read in place on the target context of the input RNA and the melting
+         * temperatures of its binding arms kept there for the next candidates
+         * \param candidate Candidate being evaluated
+         * \param targetContext Target context of input RNA
+         * \param pairingIndex Pairing index of the structure of input RNA
+         * \param cutsiteIndices Cutsites on RNA input (beginning of substrate sequence), at least one
+         * \param context Model context of the job
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \return accessibilityScores Float evaluation score values, one per cutsite index
+         */
+        public float[] CandidateScore(Candidate candidate, TargetContext targetContext, PairingIndex pairingIndex, IList<int> cutsiteIndices, ModelContext context, out float temperatureScore)
+        {
+            var indices = cutsiteIndices.ToArray();
+            var accessibilityScores = new float[indices.Length];
+
+            R_STATUS status = target_context_candidate_score(context.Handle, targetContext.Handle, candidate.SubstrateStructure ?? "", pairingIndex.Handle,
+                indices, new UIntPtr((uint)indices.Length), 0.0f, 0.0f, 0.0f, out temperatureScore, accessibilityScores);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return accessibilityScores;
+        }
+
+        /*! \fn CreateTargetContext
+         * \brief Algorithm function to validate and pack an input RNA once,
+         * for the annealing temperature of every candidate on it
+         * \param rnaInput input RNA
+         * \return targetContext Target context, to be disposed once all candidates are scored
+         */
+        public TargetContext CreateTargetContext(string rnaInput)
+        {
+            R_STATUS status = target_context_create(rnaInput, out IntPtr handle);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return new TargetContext(handle);
+        }
+
+        /*! \fn CreatePairingIndex
+         * \brief Algorithm function to index the paired positions of a folded RNA once,
+         * for the accessibility of every candidate on it
+         * \param rnaStructure structure of input RNA
+         * \return pairingIndex Pairing index, to be disposed once all candidates are scored
+         */
+        public PairingIndex CreatePairingIndex(string rnaStructure)
+        {
+            R_STATUS status = pairing_index_create(rnaStructure, out IntPtr handle);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return new PairingIndex(handle);
+        }
+
+        /*! \fn CandidateScore
+         * \brief Algorithm function to determine, in one call, the annealing temperature of a
+         * candidate given by its UTF-8 substrate and the accessibility of each of its cutsites
+         * on an indexed input RNA; the substrate is read in place, without marshalling strings
+         * \param substrateSequence UTF-8 bytes of the substrate sequence of the candidate
+         * \param substrateStructure UTF-8 bytes of the substrate structure of the candidate
+         * \param pairingIndex Pairing index of the structure of input RNA
+         * \param cutsiteIndices Cutsites on RNA input (beginning of substrate sequence)
+         * \param naConcentration Concentration of sodium
+         * \param probeConcentration Concentration of probe
+         * \param targetTemperature Target temperature of binding arms
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \return accessibilityScores Float evaluation score values, one per cutsite index
+         */
+        public float[] CandidateScore(ReadOnlySpan<byte> substrateSequence, ReadOnlySpan<byte> substrateStructure, PairingIndex pairingIndex, IList<int> cutsiteIndices, float naConcentration, float probeConcentration, float targetTemperature, out float temperatureScore)
+        {
+            var indices = cutsiteIndices.ToArray();
+            var accessibilityScores = new float[indices.Length];
+
+            R_STATUS status = candidate_score_indexed_view(IntPtr.Zero, ref MemoryMarshal.GetReference(substrateSequence), new UIntPtr((uint)substrateSequence.Length),
+                ref MemoryMarshal.GetReference(substrateStructure), new UIntPtr((uint)substrateStructure.Length), pairingIndex.Handle,
+                indices, new UIntPtr((uint)indices.Length), naConcentration, probeConcentration, targetTemperature, out temperatureScore, accessibilityScores);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return accessibilityScores;
+        }
+
+        /*! \fn CandidateScore
+         * \brief Algorithm function to determine, in one call, the annealing temperature of this
+         * particular candidate and its accessibility over the ensemble of the input RNA at each of its cutsites
+         * \param candidate Candidate being evaluated
+         * \param unpairedProfile Unpaired profile of the input RNA, covering the binding arm lengths of the candidate
+         * \param cutsiteIndices Cutsites on RNA input (beginning of substrate sequence)
+         * \param naConcentration Concentration of sodium
+         * \param probeConcentration Concentration of probe
+         * \param targetTemperature Target temperature of binding arms
+         * \param temperatureScore Out parameter for the annealing temperature score
+         * \return accessibilityScores Float evaluation score values, one per cutsite index
+         */
+        public float[] CandidateScore(Candidate candidate, UnpairedProfile unpairedProfile, IList<int> cutsiteIndices, float naConcentration, float probeConcentration, float targetTemperature, out float temperatureScore)
+        {
+            var indices = cutsiteIndices.ToArray();
+            var accessibilityScores = new float[indices.Length];
+
+            R_STATUS status = candidate_score_profiled(IntPtr.Zero, candidate.SubstrateSequence ?? "", candidate.SubstrateStructure ?? "", unpairedProfile.Handle,
+                indices, new UIntPtr((uint)indices.Length), naConcentration, probeConcentration, targetTemperature, out temperatureScore, accessibilityScores);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return accessibilityScores;
+        }
+
+        /*! \fn CreateUnpairedProfile
+         * \brief Algorithm function to fold the ensemble of an RNA once, keeping the probability that
+         * each stretch of the given lengths is unpaired, for the accessibility of every candidate on it
+         * \param rnaSequence sequence of input RNA
+         * \param stretchLengths Binding arm lengths in use
+         * \param windowSize Size of the sliding window (0 for the whole RNA)
+         * \param maxBasePairSpan Maximum span of a base pair (0 for the window size)
+         * \param context Model context of the job, or null for the default model
+         * \return unpairedProfile Unpaired profile, to be disposed once all candidates are scored
+         */
+        public UnpairedProfile CreateUnpairedProfile(string rnaSequence, IEnumerable<int> stretchLengths, int windowSize = 0, int maxBasePairSpan = 0, ModelContext? context = null)
+        {
+            var lengths = stretchLengths.ToArray();
+            R_STATUS status = unpaired_profile_create(context?.Handle ?? IntPtr.Zero, rnaSequence, lengths, new UIntPtr((uint)lengths.Length), windowSize, maxBasePairSpan, out IntPtr handle);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return new UnpairedProfile(handle);
+        }
+
         /*! \fn Anneal
          * \brief Algorithm function to determine the annealing temperature of the cutsite on the input RNA with this particular candidate sequence
          * \param candidate Candidate being evaluated
@@ -197,29 +707,101 @@ namespace Ribosoft
         /*! \fn Fold
          * \brief Algorithm function to fold an RNA sequence
          * \param sequence Sequence to be folded
+         * \param context Model context of the job, or null for the default model
          * \return foldOutputs List of fold outputs, including the structure and its probability
          */
-        public IList<FoldOutput> Fold(string sequence)
+        public IList<FoldOutput> Fold(string sequence, ModelContext? context = null)
         {
-            R_STATUS status = fold(sequence, out IntPtr outputPtr, out int size);
+            R_STATUS status = fold_arena_create(context?.Handle ?? IntPtr.Zero, sequence, out IntPtr arenaPtr);
 
             if (status != R_STATUS.R_STATUS_OK)
             {
                 throw new RibosoftAlgoException(status);
             }
 
-            var currentPtr = outputPtr;
-            var foldOutputs = new FoldOutput[size];
-            var foldOutputSize = Marshal.SizeOf<FoldOutput>();
+            try
+            {
+                // one copy per column instead of one marshalled structure per fold
+                var arena = Marshal.PtrToStructure<FoldArena>(arenaPtr);
+                var count = (int)arena.Count;
+                var stride = (int)arena.Stride;
+
+                var probabilities = new float[count];
+                Marshal.Copy(arena.Probabilities, probabilities, 0, count);
+
+                var structures = new byte[count * stride];
+                Marshal.Copy(arena.Structures, structures, 0, structures.Length);
+
+                var foldOutputs = new FoldOutput[count];
+                for (int i = 0; i < count; ++i)
+                {
+                    foldOutputs[i].Structure = Encoding.ASCII.GetString(structures, i * stride, stride - 1);
+                    foldOutputs[i].Probability = probabilities[i];
+                }
+
+                return foldOutputs;
+            }
+            finally
+            {
+                fold_arena_free(arenaPtr);
+            }
+        }
+
+        /*! \fn FoldBatch
+         * \brief Algorithm function to fold a batch of RNA sequences in parallel
+         * \param sequences Sequences to be folded
+         * \param context Model context of the job, or null for the default model
+         * \return foldOutputs List of fold outputs for each sequence, in input order
+         */
+        public IList<IList<FoldOutput>> FoldBatch(IList<string> sequences, ModelContext? context = null)
+        {
+            var results = new List<IList<FoldOutput>>(sequences.Count);
+            if (sequences.Count == 0)
+            {
+                return results;
+            }
+
+            var count = new UIntPtr((uint)sequences.Count);
+            var outputPtrs = new IntPtr[sequences.Count];
+            var sizes = new UIntPtr[sequences.Count];
+            var statuses = new R_STATUS[sequences.Count];
 
-            for (int i = 0; i < size; ++i, currentPtr += foldOutputSize)
+            R_STATUS status = fold_batch(context?.Handle ?? IntPtr.Zero, sequences.ToArray(), count, 0, outputPtrs, sizes, statuses);
+
+            if (status != R_STATUS.R_STATUS_OK)
             {
-                foldOutputs[i] = Marshal.PtrToStructure<FoldOutput>(currentPtr);
+                throw new RibosoftAlgoException(status);
             }
 
-            fold_output_free(outputPtr, size);
+            try
+            {
+                var foldOutputSize = Marshal.SizeOf<FoldOutput>();
+
+                for (int i = 0; i < sequences.Count; ++i)
+                {
+                    if (statuses[i] != R_STATUS.R_STATUS_OK)
+                    {
+                        throw new RibosoftAlgoException(statuses[i]);
+                    }
+
+                    var size = (int)sizes[i];
+                    var currentPtr = outputPtrs[i];
+                    var foldOutputs = new FoldOutput[size];
+
+                    for (int j = 0; j < size; ++j, currentPtr += foldOutputSize)
+                    {
+                        foldOutputs[j] = Marshal.PtrToStructure<FoldOutput>(currentPtr);
+                    }
 
-            return foldOutputs;
+                    results.Add(foldOutputs);
+                }
+            }
+            finally
+            {
+                fold_batch_free(outputPtrs, sizes, count);
+            }
+
+            return results;
         }
 
         /*! \fn MFEFold
@@ -242,61 +824,238 @@ namespace Ribosoft
             return rnaStructure ?? "";
         }
 
+        /*! \fn MFEFold
+         * \brief Algorithm function to fold UTF-8 input using ViennaRNA's default fold,
+         * read in place without converting it to a string
+         * \param sequence UTF-8 bytes of the sequence to be folded
+         * \return rnaStructure String containing the structure of the folded RNA
+        */
+        public string MFEFold(ReadOnlySpan<byte> sequence)
+        {
+            R_STATUS status = mfe_default_fold_view(ref MemoryMarshal.GetReference(sequence), new UIntPtr((uint)sequence.Length), out IntPtr structure);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            string? rnaStructure = Marshal.PtrToStringAnsi(structure);
+            mfe_default_fold_free(structure);
+
+            return rnaStructure ?? "";
+        }
+
+        /*! \fn MFEFold
+         * \brief Algorithm function to fold the input with ViennaRNA under the conditions of a model context
+         * \param sequence Sequence to be folded
+         * \param context Model context of the job
+         * \return rnaStructure String containing the structure of the folded RNA
+        */
+        public string MFEFold(string sequence, ModelContext context)
+        {
+            R_STATUS status = mfe_fold_with_context(context.Handle, sequence, out IntPtr structure);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            string? rnaStructure = Marshal.PtrToStringAnsi(structure);
+            mfe_default_fold_free(structure);
+
+            return rnaStructure ?? "";
+        }
+
+        /*! \fn CreateModelContext
+         * \brief Algorithm function to set the folding and annealing conditions of a job once,
+         * with the energy parameters precomputed at its temperature
+         * \param temperature Target temperature
+         * \param naConcentration Sodium (Na+) concentration
+         * \param probeConcentration Nucleic acid concentration in excess
+         * \param dangles Dangling end model (2 by default)
+         * \param maxBasePairSpan Maximum span of a base pair (-1 for no maximum)
+         * \return modelContext Model context, to be disposed by the caller
+         */
+        public ModelContext CreateModelContext(float temperature, float naConcentration, float probeConcentration, int dangles = 2, int maxBasePairSpan = -1)
+        {
+            R_STATUS status = model_context_create(temperature, dangles, maxBasePairSpan, naConcentration, probeConcentration, out IntPtr handle);
+
+            if (status != R_STATUS.R_STATUS_OK)
+            {
+                throw new RibosoftAlgoException(status);
+            }
+
+            return new ModelContext(handle);
+        }
+
         /*! \fn Structure
          * \brief Algorithm function to determine the accuracy of the predicted structure to the ideal structure
          * \param designs Designs being evaluated
+         * \param context Model context of the job, or null for the default model
          * \return void
          */
-        public void Structure(IList<Design> designs)
+        public void Structure(IList<Design> designs, ModelContext? context = null)
         {
-            IList<IList<Tuple<float, float>>> structureResults = new List<IList<Tuple<float, float>>>();
-
-            IList<Tuple<float, float>> currentResults;
-            string idealStructure;
+            var weightedDistances = new float[designs.Count];
+            var maxDistances = new float[designs.Count];
+            var probabilities = new float[designs.Count];
 
-            // Store distance and probability for further use, once we have the max distance
-            foreach (var d in designs)
+            // Fold designs and compare them to their ideal structure natively in parallel, one batch at a time
+            for (int start = 0; start < designs.Count; start += FoldBatchSize)
             {
-                currentResults = new List<Tuple<float, float>>();
+                int count = Math.Min(FoldBatchSize, designs.Count - start);
+                var sequences = new string[count];
+                var ideals = new string[count];
+                var batchWeightedDistances = new float[count];
+                var batchMaxDistances = new float[count];
+                var batchProbabilities = new float[count];
+                var statuses = new R_STATUS[count];
 
-                var foldOutputs = Fold(d.Sequence);
+                for (int i = 0; i < count; i++)
+                {
+                    sequences[i] = designs[start + i].Sequence;
+                    ideals[i] = designs[start + i].IdealStructure;
+                }
 
-                idealStructure = d.IdealStructure;
+                R_STATUS status = structure_score_batch(context?.Handle ?? IntPtr.Zero, sequences, ideals, new UIntPtr((uint)count), 0,
+                    batchWeightedDistances, batchMaxDistances, batchProbabilities, statuses);
 
-                foreach (var output in foldOutputs)
+                if (status != R_STATUS.R_STATUS_OK)
                 {
-                    R_STATUS status = structure(output.Structure, idealStructure, out float distance);
+                    throw new RibosoftAlgoException(status);
+                }
 
-                    if (status != R_STATUS.R_STATUS_OK)
+                for (int i = 0; i < count; i++)
+                {
+                    if (statuses[i] != R_STATUS.R_STATUS_OK)
                     {
-                        throw new RibosoftAlgoException(status);
+                        throw new RibosoftAlgoException(statuses[i]);
                     }
 
-                    currentResults.Add(new Tuple<float, float>(distance, output.Probability));
+                    weightedDistances[start + i] = batchWeightedDistances[i];
+                    maxDistances[start + i] = batchMaxDistances[i];
+                    probabilities[start + i] = batchProbabilities[i];
                 }
+            }
 
-                structureResults.Add(currentResults);
+            float maxDistance = maxDistances.Max();
+
+            // sum((1 - distance / maxDistance) * probability) == probability - weightedDistance / maxDistance
+            for (int i = 0; i < designs.Count; i++)
+            {
+                designs[i].StructureScore = 1 - (probabilities[i] - (weightedDistances[i] / maxDistance));
             }
+        }
 
-            if (designs.Count != structureResults.Count)
+        /*! \class PairingIndex
+         * \brief Native pairing index of a folded RNA, released on dispose
+         */
+        public sealed class PairingIndex : IDisposable
+        {
+            /*! \property Handle
+             * \brief Pointer to the native pairing index
+             */
+            internal IntPtr Handle { get; private set; }
+
+            internal PairingIndex(IntPtr handle)
             {
-                throw new RibosoftAlgoException(R_STATUS.R_STRUCT_LENGTH_DIFFER);
+                Handle = handle;
             }
 
-            float maxDistance = structureResults.Max(results => results.Max(r => r.Item1));
+            /*! \fn Dispose
+             * \brief Free the native pairing index
+             */
+            public void Dispose()
+            {
+                if (Handle != IntPtr.Zero)
+                {
+                    pairing_index_free(Handle);
+                    Handle = IntPtr.Zero;
+                }
+            }
+        }
 
-            float currentStructureScore;
+        /*! \class TargetContext
+         * \brief Native target context of an input RNA, released on dispose
+         */
+        public sealed class TargetContext : IDisposable
+        {
+            /*! \property Handle
+             * \brief Pointer to the native target context
+             */
+            internal IntPtr Handle { get; private set; }
 
-            for (int i = 0; i < designs.Count; i++)
+            internal TargetContext(IntPtr handle)
             {
-                currentStructureScore = 0.0f;
+                Handle = handle;
+            }
 
-                foreach (Tuple<float, float> foldResults in structureResults[i])
+            /*! \fn Dispose
+             * \brief Free the native target context
+             */
+            public void Dispose()
+            {
+                if (Handle != IntPtr.Zero)
                 {
-                    currentStructureScore += (1 - (foldResults.Item1 / maxDistance)) * foldResults.Item2;
+                    target_context_free(Handle);
+                    Handle = IntPtr.Zero;
                 }
+            }
+        }
 
-                designs[i].StructureScore = 1 - currentStructureScore;
+        /*! \class UnpairedProfile
+         * \brief Native unpaired profile of an RNA, released on dispose
+         */
+        public sealed class UnpairedProfile : IDisposable
+        {
+            /*! \property Handle
+             * \brief Pointer to the native unpaired profile
+             */
+            internal IntPtr Handle { get; private set; }
+
+            internal UnpairedProfile(IntPtr handle)
+            {
+                Handle = handle;
+            }
+
+            /*! \fn Dispose
+             * \brief Free the native unpaired profile
+             */
+            public void Dispose()
+            {
+                if (Handle != IntPtr.Zero)
+                {
+                    unpaired_profile_free(Handle);
+                    Handle = IntPtr.Zero;
+                }
+            }
+        }
+
+        /*! \class ModelContext
+         * \brief Native model context of a job, released on dispose
+         */
+        public sealed class ModelContext : IDisposable
+        {
+            /*! \property Handle
+             * \brief Pointer to the native model context
+             */
+            internal IntPtr Handle { get; private set; }
+
+            internal ModelContext(IntPtr handle)
+            {
+                Handle = handle;
+            }
+
+            /*! \fn Dispose
+             * \brief Free the native model context
+             */
+            public void Dispose()
+            {
+                if (Handle != IntPtr.Zero)
+                {
+                    model_context_free(Handle);
+                    Handle = IntPtr.Zero;
+                }
             }
         }
     }
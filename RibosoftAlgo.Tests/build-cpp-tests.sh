@@ -28,16 +28,33 @@ TEST_SOURCES=(
     "$SCRIPT_DIR/test/test_fold.cpp"
     "$SCRIPT_DIR/test/test_structure.cpp"
     "$SCRIPT_DIR/test/test_accessibility.cpp"
+    "$SCRIPT_DIR/test/test_target_context.cpp"
+    "$SCRIPT_DIR/test/test_substrate_template.cpp"
+    "$SCRIPT_DIR/test/test_pairing_index.cpp"
+    "$SCRIPT_DIR/test/test_fold_pool.cpp"
+    "$SCRIPT_DIR/test/test_model_context.cpp"
+    "$SCRIPT_DIR/test/test_local_fold.cpp"
+    "$SCRIPT_DIR/test/test_unpaired_profile.cpp"
+    "$SCRIPT_DIR/test/test_packed_sequence.cpp"
 )
 
 # Main library source files (needed for testing)
 LIB_SOURCES=(
     "$SCRIPT_DIR/../RibosoftAlgo/src/anneal.cpp"
+    "$SCRIPT_DIR/../RibosoftAlgo/src/target_context.cpp"
+    "$SCRIPT_DIR/../RibosoftAlgo/src/substrate_template.cpp"
     "$SCRIPT_DIR/../RibosoftAlgo/src/validation.cpp" 
     "$SCRIPT_DIR/../RibosoftAlgo/src/fold.cpp"
+    "$SCRIPT_DIR/../RibosoftAlgo/src/fold_pool.cpp"
+    "$SCRIPT_DIR/../RibosoftAlgo/src/model_context.cpp"
     "$SCRIPT_DIR/../RibosoftAlgo/src/structure.cpp"
+    "$SCRIPT_DIR/../RibosoftAlgo/src/tree_distance.cpp"
     "$SCRIPT_DIR/../RibosoftAlgo/src/accessibility.cpp"
+    "$SCRIPT_DIR/../RibosoftAlgo/src/pairing_index.cpp"
     "$SCRIPT_DIR/../RibosoftAlgo/src/mfe_default_fold.cpp"
+    "$SCRIPT_DIR/../RibosoftAlgo/src/local_fold.cpp"
+    "$SCRIPT_DIR/../RibosoftAlgo/src/unpaired_profile.cpp"
+    "$SCRIPT_DIR/../RibosoftAlgo/src/packed_sequence.cpp"
 )
 
 # Include paths
@@ -1,6 +1,7 @@
 #include <catch2/catch_amalgamated.hpp>
 
 #include <cmath>
+#include <string>
 
 #include "functions.h"
 
@@ -36,3 +37,125 @@ TEST_CASE("Invalid structure length", "[accessibility]") {
     REQUIRE(status == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
     REQUIRE(score == -1.0f);
 }
+
+TEST_CASE("Candidate score across cutsites", "[accessibility]") {
+    const std::string rna = "...((()((.)).)..........()......";
+    const int cutsites[] = { 0, 15, 3 };
+
+    float temperature = -1.0f;
+    float scores[3] = { -1.0f, -1.0f, -1.0f };
+    R_STATUS status = candidate_score(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", rna.c_str(), cutsites, 3, 1.0f, 0.5f, 22.0f, temperature, scores);
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+
+    float expected;
+    REQUIRE(anneal("CAACUGCAUGUGAUG", "cba987654..3210", 1.0f, 0.5f, 22.0f, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temperature == Approx(expected));
+
+    for (int i = 0; i < 3; ++i) {
+        float score;
+        REQUIRE(accessibility("CAACUGCAUGUGAUG", "cba987654..3210", rna.substr(cutsites[i], 15).c_str(), 1.0f, 0.5f, 22.0f, score) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(scores[i] == Approx(score));
+    }
+    REQUIRE(scores[1] == 0.0f);
+}
+
+TEST_CASE("Candidate score cutsite out of range", "[accessibility]") {
+    const int cutsites[] = { 0, 10 };
+
+    float temperature = -1.0f;
+    float scores[2] = { -1.0f, -1.0f };
+    R_STATUS status = candidate_score(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", "....................", cutsites, 2, 1.0f, 0.5f, 22.0f, temperature, scores);
+    REQUIRE(status == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(temperature == -1.0f);
+
+    const int negative[] = { -1 };
+    status = candidate_score(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", "....................", negative, 1, 1.0f, 0.5f, 22.0f, temperature, scores);
+    REQUIRE(status == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+
+    status = candidate_score(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", "", nullptr, 0, 1.0f, 0.5f, 22.0f, temperature, nullptr);
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+
+    float expected;
+    REQUIRE(anneal("CAACUGCAUGUGAUG", "cba987654..3210", 1.0f, 0.5f, 22.0f, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temperature == Approx(expected));
+}
+
+TEST_CASE("Candidate score of a validated sequence", "[accessibility]") {
+    const std::string rna = "...((()((.)).)..........()......";
+    const int cutsites[] = { 0, 15, 3 };
+
+    validated_sequence* sequence = nullptr;
+    substrate_template* structure = nullptr;
+    pairing_index* index = nullptr;
+    REQUIRE(validated_sequence_create("CAACUGCAUGUGAUG", sequence) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(substrate_template_create("cba987654..3210", structure) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(pairing_index_create(rna.c_str(), index) == R_SUCCESS::R_STATUS_OK);
+
+    float expected_temperature, temperature;
+    float expected[3], scores[3];
+    REQUIRE(candidate_score(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", rna.c_str(), cutsites, 3, 1.0f, 0.5f, 22.0f, expected_temperature, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(candidate_score_validated(nullptr, sequence, structure, index, cutsites, 3, 1.0f, 0.5f, 22.0f, temperature, scores) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temperature == Approx(expected_temperature));
+
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(scores[i] == Approx(expected[i]));
+
+        float score;
+        REQUIRE(accessibility_validated(sequence, structure, rna.substr(cutsites[i], 15).c_str(), 1.0f, 0.5f, 22.0f, score) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(score == Approx(expected[i]));
+    }
+
+    const int outside[] = { 18 };
+    REQUIRE(candidate_score_validated(nullptr, sequence, structure, index, outside, 1, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(candidate_score_validated(nullptr, sequence, structure, nullptr, cutsites, 3, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    float score;
+    REQUIRE(accessibility_validated(sequence, structure, "....", 1.0f, 0.5f, 22.0f, score) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+    REQUIRE(accessibility_validated(sequence, structure, nullptr, 1.0f, 0.5f, 22.0f, score) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    pairing_index_free(index);
+    substrate_template_free(structure);
+    validated_sequence_free(sequence);
+}
+
+TEST_CASE("Candidate score of views", "[accessibility]") {
+    // substrate sequence and structure given as ranges of longer strings
+    const std::string candidate = "GGCAACUGCAUGUGAUGXX";
+    const std::string structures = "cba987654..3210cba987654..3210";
+    const std::string rna = "...((()((.)).)..........()......";
+    const int cutsites[] = { 0, 15, 3 };
+
+    float expected_temperature, temperature;
+    float expected[3], scores[3];
+    REQUIRE(candidate_score(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", rna.c_str(), cutsites, 3, 1.0f, 0.5f, 22.0f, expected_temperature, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(candidate_score_view(nullptr, candidate.data() + 2, 15, structures.data() + 15, 15, rna.data(), rna.size(), cutsites, 3, 1.0f, 0.5f, 22.0f, temperature, scores) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temperature == Approx(expected_temperature));
+
+    pairing_index* index = nullptr;
+    REQUIRE(pairing_index_create_view(rna.data(), rna.size(), index) == R_SUCCESS::R_STATUS_OK);
+
+    float indexed[3];
+    REQUIRE(candidate_score_indexed_view(nullptr, candidate.data() + 2, 15, structures.data() + 15, 15, index, cutsites, 3, 1.0f, 0.5f, 22.0f, temperature, indexed) == R_SUCCESS::R_STATUS_OK);
+
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(scores[i] == Approx(expected[i]));
+        REQUIRE(indexed[i] == Approx(expected[i]));
+
+        // the folded structure at the cutsite is read in place
+        float score;
+        REQUIRE(accessibility_view(candidate.data() + 2, 15, structures.data() + 15, 15, rna.data() + cutsites[i], 15, 1.0f, 0.5f, 22.0f, score) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(score == Approx(expected[i]));
+
+        float temp;
+        REQUIRE(anneal_view(candidate.data() + 2, 15, structures.data() + 15, 15, 1.0f, 0.5f, 22.0f, temp) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(temp == Approx(expected_temperature));
+    }
+
+    pairing_index_free(index);
+
+    float score;
+    REQUIRE(accessibility_view(candidate.data() + 2, 16, structures.data() + 15, 15, rna.data(), 15, 1.0f, 0.5f, 22.0f, score) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(accessibility_view(candidate.data() + 2, 15, structures.data() + 15, 14, rna.data(), 15, 1.0f, 0.5f, 22.0f, score) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+    REQUIRE(candidate_score_view(nullptr, candidate.data() + 2, 15, structures.data() + 15, 15, rna.data(), 17, cutsites, 3, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(pairing_index_create_view(rna.data(), 0, index) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+}
@@ -70,6 +70,12 @@ TEST_CASE("invalid (very small) concentration", "[anneal]") {
     REQUIRE(status == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
 }
 
+TEST_CASE("invalid (NaN) concentration", "[anneal]") {
+    float temp;
+    REQUIRE(anneal("AAUUUCCCCGGGGG", "0123abxyzABXYZ", std::nanf(""), 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
+    REQUIRE(anneal("AAUUUCCCCGGGGG", "0123abxyzABXYZ", 1.0f, std::nanf(""), 22.0f, temp) == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
+}
+
 TEST_CASE("invalid base", "[anneal]") {
     const char* sequence = "AAU_UCCCCGGGGG";
     const char* structure = "0123ABXYZABXYZ";
@@ -105,4 +111,89 @@ TEST_CASE("invalid arm length of one", "[anneal]") {
 
     REQUIRE(status == R_SUCCESS::R_STATUS_OK);
     REQUIRE(temp == 0.0f);
-}
\ No newline at end of file
+}
+
+TEST_CASE("melting temperature", "[anneal]") {
+    // single arms of "Simple check" and "simple sequence and structure", with
+    // their MELTING temperatures recovered from the scores (22 + sqrt(score))
+    const char* sequences[] = { "AUGAUCGAUGCUGUAGCUGACU", "AAUUUCCCCGGGGG" };
+    const char* structures[] = { "0000000000000000000000", "0123abxyzABXYZ" };
+    const float references[] = { 90.4683f, 89.6045f };
+
+    for (int i = 0; i < 2; ++i) {
+        float melting, temp;
+        REQUIRE(melting_temperature(sequences[i], 1.0f, 0.05f, melting) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(melting == Approx(references[i]));
+
+        REQUIRE(anneal(sequences[i], structures[i], 1.0f, 0.05f, 22.0f, temp) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(temp == Approx(std::pow(melting - 22.0f, 2)));
+    }
+}
+
+TEST_CASE("invalid melting temperature parameters", "[anneal]") {
+    float temp;
+    REQUIRE(melting_temperature(nullptr, 1.0f, 0.05f, temp) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(melting_temperature("", 1.0f, 0.05f, temp) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(melting_temperature("A", 1.0f, 0.05f, temp) == R_APPLICATION_ERROR::R_INVALID_ARM_LENGTH);
+    REQUIRE(melting_temperature("AXGU", 1.0f, 0.05f, temp) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(melting_temperature("ACGU", 0.0f, 0.05f, temp) == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
+}
+
+TEST_CASE("melting cache", "[anneal]") {
+    melting_cache_clear();
+
+    float first, second;
+    REQUIRE(anneal("AAUUUCCCCGGGGG", "0123abxy..BXYZ", 1.0f, 0.05f, 22.0f, first) == R_SUCCESS::R_STATUS_OK);
+
+    uint64_t hits, misses;
+    size_t entries;
+    melting_cache_stats(hits, misses, entries);
+    REQUIRE(hits == 0);
+    REQUIRE(misses == 2);
+    REQUIRE(entries == 2);
+
+    REQUIRE(anneal("AAUUUCCCCGGGGG", "0123abxy..BXYZ", 1.0f, 0.05f, 22.0f, second) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(second == first);
+
+    melting_cache_stats(hits, misses, entries);
+    REQUIRE(hits == 2);
+    REQUIRE(misses == 2);
+
+    // different conditions are different entries
+    REQUIRE(anneal("AAUUUCCCCGGGGG", "0123abxy..BXYZ", 0.5f, 0.05f, 22.0f, second) == R_SUCCESS::R_STATUS_OK);
+    melting_cache_stats(hits, misses, entries);
+    REQUIRE(misses == 4);
+    REQUIRE(entries == 4);
+
+    melting_cache_configure(0);
+    REQUIRE(anneal("AAUUUCCCCGGGGG", "0123abxy..BXYZ", 1.0f, 0.05f, 22.0f, second) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(second == first);
+    melting_cache_stats(hits, misses, entries);
+    REQUIRE(hits == 0);
+    REQUIRE(entries == 0);
+
+    melting_cache_configure(1 << 18);
+}
+
+TEST_CASE("validated sequence", "[anneal]") {
+    validated_sequence* sequence = nullptr;
+    substrate_template* structure = nullptr;
+    REQUIRE(validated_sequence_create("CAACUGCAUGUGAUG", sequence) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(substrate_template_create("cba987654..3210", structure) == R_SUCCESS::R_STATUS_OK);
+
+    float expected, temp;
+    REQUIRE(anneal("CAACUGCAUGUGAUG", "cba987654..3210", 1.0f, 0.5f, 22.0f, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(anneal_validated(sequence, structure, 1.0f, 0.5f, 22.0f, temp) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temp == Approx(expected));
+
+    REQUIRE(anneal_validated(sequence, structure, 0.0f, 0.5f, 22.0f, temp) == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
+    REQUIRE(anneal_validated(nullptr, structure, 1.0f, 0.5f, 22.0f, temp) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    substrate_template* shorter = nullptr;
+    REQUIRE(substrate_template_create("cba987654..321", shorter) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(anneal_validated(sequence, shorter, 1.0f, 0.5f, 22.0f, temp) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+
+    substrate_template_free(shorter);
+    substrate_template_free(structure);
+    validated_sequence_free(sequence);
+}
@@ -1,6 +1,9 @@
 #include <catch2/catch_amalgamated.hpp>
 
 #include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
 
 #include "functions.h"
 
@@ -57,3 +60,522 @@ TEST_CASE("invalid sequence", "[fold]") {
     R_STATUS status = fold("wfef", output, size);
     REQUIRE(status == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
 }
+
+TEST_CASE("batch", "[fold]") {
+    const char* sequences[] = { "AUGUCUUAGGUGAUACGUGC", "wfef", "AUUUUAGUGCUGAUGGCCAAUGCGCGAACCCAUCGGCGCUGUGA" };
+    fold_output* outputs[3];
+    size_t sizes[3];
+    R_STATUS statuses[3];
+    R_STATUS status = fold_batch(nullptr, sequences, 3, 2, outputs, sizes, statuses);
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+
+    REQUIRE(statuses[0] == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(sizes[0] == 51);
+    REQUIRE(strcmp(outputs[0][0].structure, ".((((......)))).....") == 0);
+
+    REQUIRE(statuses[1] == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(outputs[1] == nullptr);
+    REQUIRE(sizes[1] == 0);
+
+    REQUIRE(statuses[2] == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(sizes[2] == 173);
+    REQUIRE(strcmp(outputs[2][1].structure, ".((.((((((((((((.............)))))))))))).))") == 0);
+
+    fold_batch_free(outputs, sizes, 3);
+}
+
+TEST_CASE("empty batch", "[fold]") {
+    R_STATUS status = fold_batch(nullptr, nullptr, 0, 0, nullptr, nullptr, nullptr);
+    REQUIRE(status == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+}
+
+TEST_CASE("ensemble", "[fold]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+    const size_t length = strlen(sequence);
+
+    fold_output* expected = nullptr;
+    size_t expected_size;
+    REQUIRE(fold(sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+
+    fold_output* output = nullptr;
+    size_t size;
+    fold_ensemble* ensemble = nullptr;
+    R_STATUS status = fold_with_ensemble(nullptr, sequence, 0.0f, output, size, ensemble);
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(ensemble != nullptr);
+
+    // same suboptimal structures as fold
+    REQUIRE(size == expected_size);
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(strcmp(output[i].structure, expected[i].structure) == 0);
+        REQUIRE(output[i].probability == Approx(expected[i].probability));
+    }
+
+    // every position is either unpaired or in one of the listed pairs
+    std::vector<double> total(ensemble->unpaired, ensemble->unpaired + length);
+    for (size_t k = 0; k < ensemble->pair_count; ++k) {
+        const fold_pair& pair = ensemble->pairs[k];
+        REQUIRE(pair.i < pair.j);
+        REQUIRE(pair.probability > 0.0f);
+        total[pair.i] += pair.probability;
+        total[pair.j] += pair.probability;
+
+        if (pair.probability > 0.5f) {
+            REQUIRE(ensemble->centroid[pair.i] == '(');
+            REQUIRE(ensemble->centroid[pair.j] == ')');
+        }
+    }
+    for (size_t i = 0; i < length; ++i) {
+        REQUIRE(ensemble->unpaired[i] >= 0.0f);
+        REQUIRE(ensemble->unpaired[i] <= 1.0f);
+        REQUIRE(total[i] == Approx(1.0).margin(0.001));
+    }
+
+    // the pairs of the MFE structure, of probability 0.669 or more, are in the centroid
+    REQUIRE(strlen(ensemble->centroid) == length);
+    REQUIRE(strncmp(ensemble->centroid + 1, "((((", 4) == 0);
+    REQUIRE(strncmp(ensemble->centroid + 11, "))))", 4) == 0);
+
+    fold_ensemble_free(ensemble);
+    fold_output_free(output, size);
+    fold_output_free(expected, expected_size);
+}
+
+TEST_CASE("ensemble cutoff", "[fold]") {
+    fold_output* output = nullptr;
+    size_t size;
+    fold_ensemble* ensemble = nullptr;
+    REQUIRE(fold_with_ensemble(nullptr, "AUGUCUUAGGUGAUACGUGC", 0.1f, output, size, ensemble) == R_SUCCESS::R_STATUS_OK);
+
+    for (size_t k = 0; k < ensemble->pair_count; ++k) {
+        REQUIRE(ensemble->pairs[k].probability >= 0.1f);
+    }
+
+    fold_ensemble_free(ensemble);
+    fold_output_free(output, size);
+
+    ensemble = nullptr;
+    REQUIRE(fold_with_ensemble(nullptr, "AUGUCUUAGGUGAUACGUGC", 1.5f, output, size, ensemble) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(fold_with_ensemble(nullptr, "AUGUCUUAGGUGAUACGUGCX", 0.1f, output, size, ensemble) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(ensemble == nullptr);
+}
+
+TEST_CASE("options", "[fold]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+
+    fold_output* expected = nullptr;
+    size_t expected_size;
+    REQUIRE(fold(sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+
+    // same band as fold, no bounds
+    fold_options options = { 5.0f, 0, 0.0f, FOLD_NORMALIZATION_PARTITION_FUNCTION };
+    fold_output* output = nullptr;
+    size_t size;
+    float captured;
+    REQUIRE(fold_with_options(nullptr, sequence, options, output, size, captured) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == expected_size);
+
+    std::vector<std::string> structures, expected_structures;
+    for (size_t i = 0; i < size; ++i) {
+        structures.emplace_back(output[i].structure);
+        expected_structures.emplace_back(expected[i].structure);
+        REQUIRE(output[i].probability == Approx(expected[i].probability));
+    }
+    std::sort(structures.begin(), structures.end());
+    std::sort(expected_structures.begin(), expected_structures.end());
+    REQUIRE(structures == expected_structures);
+    fold_output_free(output, size);
+
+    // lowest energies only
+    options = { 5.0f, 3, 0.0f, FOLD_NORMALIZATION_PARTITION_FUNCTION };
+    REQUIRE(fold_with_options(nullptr, sequence, options, output, size, captured) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == std::min<size_t>(3, expected_size));
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(output[i].probability == Approx(expected[i].probability));
+    }
+    fold_output_free(output, size);
+
+    // stop at half of the ensemble
+    options = { 5.0f, 0, 0.5f, FOLD_NORMALIZATION_PARTITION_FUNCTION };
+    REQUIRE(fold_with_options(nullptr, sequence, options, output, size, captured) == R_SUCCESS::R_STATUS_OK);
+    float cumulative = 0.0f;
+    for (size_t i = 0; i + 1 < size; ++i) {
+        cumulative += output[i].probability;
+    }
+    REQUIRE(cumulative < 0.5f);
+    REQUIRE(size >= 1);
+    REQUIRE((cumulative + output[size - 1].probability >= 0.5f || size == expected_size));
+    fold_output_free(output, size);
+
+    fold_output_free(expected, expected_size);
+
+    options = { -1.0f, 0, 0.0f, FOLD_NORMALIZATION_PARTITION_FUNCTION };
+    REQUIRE(fold_with_options(nullptr, sequence, options, output, size, captured) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    options = { 5.0f, 0, 1.5f, FOLD_NORMALIZATION_PARTITION_FUNCTION };
+    REQUIRE(fold_with_options(nullptr, sequence, options, output, size, captured) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+}
+
+/*! \struct stream_consumer
+ * \brief Counts streamed structures, and stops after a limit
+ */
+struct stream_consumer {
+    size_t received = 0;
+    size_t limit = 0;
+    double probability = 0.0;
+
+    static int receive(const char* structure, float probability, void* data)
+    {
+        stream_consumer& consumer = *static_cast<stream_consumer*>(data);
+        REQUIRE(strlen(structure) == 20);
+        consumer.received++;
+        consumer.probability += probability;
+        return consumer.limit == 0 || consumer.received < consumer.limit;
+    }
+};
+
+TEST_CASE("stream", "[fold]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+
+    fold_output* expected = nullptr;
+    size_t expected_size;
+    REQUIRE(fold(sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+    double expected_probability = 0.0;
+    for (size_t i = 0; i < expected_size; ++i) {
+        expected_probability += expected[i].probability;
+    }
+    fold_output_free(expected, expected_size);
+
+    fold_options options = { 5.0f, 0, 0.0f, FOLD_NORMALIZATION_PARTITION_FUNCTION };
+    stream_consumer consumer;
+    size_t size;
+    REQUIRE(fold_stream(nullptr, sequence, options, &stream_consumer::receive, &consumer, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == expected_size);
+    REQUIRE(consumer.received == expected_size);
+    REQUIRE(consumer.probability == Approx(expected_probability));
+
+    // the consumer stops
+    consumer = { 0, 2, 0.0 };
+    REQUIRE(fold_stream(nullptr, sequence, options, &stream_consumer::receive, &consumer, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == 2);
+    REQUIRE(consumer.received == 2);
+
+    // bounded count
+    options = { 5.0f, 1, 0.0f, FOLD_NORMALIZATION_PARTITION_FUNCTION };
+    consumer = {};
+    REQUIRE(fold_stream(nullptr, sequence, options, &stream_consumer::receive, &consumer, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == 1);
+
+    REQUIRE(fold_stream(nullptr, sequence, options, nullptr, nullptr, size) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+}
+
+TEST_CASE("sample", "[fold]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+
+    fold_output* output = nullptr;
+    size_t size;
+    REQUIRE(fold_sample(nullptr, sequence, 1000, false, output, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size >= 1);
+    REQUIRE(size <= 1000);
+
+    // unique structures, most probable first, with frequencies adding up to 1
+    float total = 0.0f;
+    std::vector<std::string> structures;
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(strlen(output[i].structure) == 20);
+        REQUIRE(validate_structure(output[i].structure) == R_SUCCESS::R_STATUS_OK);
+        if (i > 0) {
+            REQUIRE(output[i].probability <= output[i - 1].probability);
+        }
+        total += output[i].probability;
+        structures.emplace_back(output[i].structure);
+    }
+    REQUIRE(total == Approx(1.0f));
+    std::sort(structures.begin(), structures.end());
+    REQUIRE(std::adjacent_find(structures.begin(), structures.end()) == structures.end());
+    fold_output_free(output, size);
+}
+
+TEST_CASE("non-redundant sample", "[fold]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+
+    fold_output* expected = nullptr;
+    size_t expected_size;
+    REQUIRE(fold(sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+
+    fold_output* output = nullptr;
+    size_t size;
+    REQUIRE(fold_sample(nullptr, sequence, 5, true, output, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size >= 1);
+    REQUIRE(size <= 5);
+
+    // exact Boltzmann probabilities, as from the suboptimal structures
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < expected_size; ++j) {
+            if (strcmp(output[i].structure, expected[j].structure) == 0) {
+                REQUIRE(output[i].probability == Approx(expected[j].probability));
+            }
+        }
+    }
+
+    fold_output_free(output, size);
+    fold_output_free(expected, expected_size);
+
+    REQUIRE(fold_sample(nullptr, sequence, 0, false, output, size) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(fold_sample(nullptr, "AUGX", 10, false, output, size) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+}
+
+TEST_CASE("suboptimal normalization", "[fold]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+
+    fold_options options = { 5.0f, 0, 0.0f, FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION };
+    fold_output* exact = nullptr;
+    size_t exact_size;
+    float exact_captured;
+    REQUIRE(fold_with_options(nullptr, sequence, options, exact, exact_size, exact_captured) == R_SUCCESS::R_STATUS_OK);
+
+    float total = 0.0f;
+    for (size_t i = 0; i < exact_size; ++i) {
+        total += exact[i].probability;
+    }
+    REQUIRE(exact_captured == Approx(total));
+    REQUIRE(exact_captured <= 1.0001f);
+
+    options.normalization = FOLD_NORMALIZATION::FOLD_NORMALIZATION_SUBOPTIMAL;
+    fold_output* output = nullptr;
+    size_t size;
+    float captured;
+    REQUIRE(fold_with_options(nullptr, sequence, options, output, size, captured) == R_SUCCESS::R_STATUS_OK);
+
+    // the whole band is returned, so it holds all of the normalized probability
+    REQUIRE(size == exact_size);
+    REQUIRE(captured == Approx(1.0f));
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(strcmp(output[i].structure, exact[i].structure) == 0);
+        REQUIRE(output[i].probability == Approx(exact[i].probability / exact_captured));
+    }
+    fold_output_free(output, size);
+
+    // part of the band
+    options.max_structures = 2;
+    REQUIRE(fold_with_options(nullptr, sequence, options, output, size, captured) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == std::min<size_t>(2, exact_size));
+    REQUIRE(captured == Approx((exact[0].probability + (size > 1 ? exact[1].probability : 0.0f)) / exact_captured));
+    fold_output_free(output, size);
+
+    fold_output_free(exact, exact_size);
+
+    // streamed probabilities need the partition function
+    size_t streamed;
+    REQUIRE(fold_stream(nullptr, sequence, options, &stream_consumer::receive, nullptr, streamed) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    options.normalization = 5;
+    REQUIRE(fold_with_options(nullptr, sequence, options, output, size, captured) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+}
+
+TEST_CASE("columns", "[fold]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+    const size_t stride = strlen(sequence) + 1;
+
+    fold_output* expected = nullptr;
+    size_t expected_size;
+    REQUIRE(fold(sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(expected_size > 1);
+
+    SECTION("caller buffers") {
+        std::vector<char> structures(expected_size * stride);
+        std::vector<float> probabilities(expected_size);
+        std::vector<float> energies(expected_size);
+        size_t size;
+
+        REQUIRE(fold_into(nullptr, sequence, expected_size, structures.data(), probabilities.data(), energies.data(), size) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(size == expected_size);
+        for (size_t i = 0; i < size; ++i) {
+            REQUIRE(strcmp(structures.data() + i * stride, expected[i].structure) == 0);
+            REQUIRE(probabilities[i] == Approx(expected[i].probability));
+        }
+        REQUIRE(std::is_sorted(energies.begin(), energies.end()));
+
+        // smaller buffers keep the lowest energy structures and report the full size
+        std::vector<char> first(stride, 'x');
+        float probability;
+        REQUIRE(fold_into(nullptr, sequence, 1, first.data(), &probability, nullptr, size) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(size == expected_size);
+        REQUIRE(strcmp(first.data(), expected[0].structure) == 0);
+        REQUIRE(probability == Approx(expected[0].probability));
+
+        // sizing call
+        REQUIRE(fold_into(nullptr, sequence, 0, nullptr, nullptr, nullptr, size) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(size == expected_size);
+
+        REQUIRE(fold_into(nullptr, sequence, 1, nullptr, &probability, nullptr, size) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+        REQUIRE(fold_into(nullptr, "AUGX", 0, nullptr, nullptr, nullptr, size) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    }
+
+    SECTION("arena") {
+        fold_arena* arena = nullptr;
+        REQUIRE(fold_arena_create(nullptr, sequence, arena) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(arena != nullptr);
+        REQUIRE(arena->count == expected_size);
+        REQUIRE(arena->stride == stride);
+        for (size_t i = 0; i < arena->count; ++i) {
+            REQUIRE(strcmp(arena->structures + i * arena->stride, expected[i].structure) == 0);
+            REQUIRE(arena->probabilities[i] == Approx(expected[i].probability));
+        }
+        REQUIRE(std::is_sorted(arena->energies, arena->energies + arena->count));
+        fold_arena_free(arena);
+
+        REQUIRE(fold_arena_create(nullptr, "AUGX", arena) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+        REQUIRE(arena == nullptr);
+    }
+
+    fold_output_free(expected, expected_size);
+}
+
+TEST_CASE("validated sequence", "[fold]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+
+    validated_sequence* handle = nullptr;
+    REQUIRE(validated_sequence_create(sequence, handle) == R_SUCCESS::R_STATUS_OK);
+
+    fold_output* expected = nullptr;
+    fold_output* output = nullptr;
+    size_t expected_size, size;
+    REQUIRE(fold(sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(fold_validated(nullptr, handle, output, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == expected_size);
+
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(strcmp(output[i].structure, expected[i].structure) == 0);
+        REQUIRE(output[i].probability == Approx(expected[i].probability));
+    }
+
+    fold_output_free(output, size);
+    fold_output_free(expected, expected_size);
+
+    char* expected_mfe = nullptr;
+    char* mfe = nullptr;
+    REQUIRE(mfe_default_fold(sequence, expected_mfe) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(mfe_fold_validated(nullptr, handle, mfe) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(strcmp(mfe, expected_mfe) == 0);
+    mfe_default_fold_free(mfe);
+    mfe_default_fold_free(expected_mfe);
+
+    REQUIRE(fold_validated(nullptr, nullptr, output, size) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(mfe_fold_validated(nullptr, nullptr, mfe) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    validated_sequence_free(handle);
+}
+
+TEST_CASE("validated sequence and view in a model context", "[fold]") {
+    const std::string rna = "XXXAUGUCUUAGGUGAUACGUGCXX";
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+
+    model_context* context = nullptr;
+    REQUIRE(model_context_create(25.0f, 2, -1, 1.0f, 0.05f, context) == R_SUCCESS::R_STATUS_OK);
+
+    validated_sequence* handle = nullptr;
+    REQUIRE(validated_sequence_create(sequence, handle) == R_SUCCESS::R_STATUS_OK);
+
+    fold_output* expected = nullptr;
+    size_t expected_size;
+    REQUIRE(fold_with_context(context, sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+
+    fold_output* validated = nullptr;
+    fold_output* view = nullptr;
+    size_t validated_size, view_size;
+    REQUIRE(fold_validated(context, handle, validated, validated_size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(fold_view(context, rna.data() + 3, 20, view, view_size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(validated_size == expected_size);
+    REQUIRE(view_size == expected_size);
+
+    std::vector<char> structures(expected_size * 21);
+    std::vector<float> probabilities(expected_size);
+    size_t into_size;
+    REQUIRE(fold_into(context, sequence, expected_size, structures.data(), probabilities.data(), nullptr, into_size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(into_size == expected_size);
+
+    for (size_t i = 0; i < expected_size; ++i) {
+        REQUIRE(strcmp(validated[i].structure, expected[i].structure) == 0);
+        REQUIRE(validated[i].probability == Approx(expected[i].probability));
+        REQUIRE(strcmp(view[i].structure, expected[i].structure) == 0);
+        REQUIRE(view[i].probability == Approx(expected[i].probability));
+        REQUIRE(strcmp(structures.data() + i * 21, expected[i].structure) == 0);
+        REQUIRE(probabilities[i] == Approx(expected[i].probability));
+    }
+
+    fold_output_free(view, view_size);
+    fold_output_free(validated, validated_size);
+    fold_output_free(expected, expected_size);
+
+    char* expected_mfe = nullptr;
+    char* mfe = nullptr;
+    REQUIRE(mfe_fold_with_context(context, sequence, expected_mfe) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(mfe_fold_validated(context, handle, mfe) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(strcmp(mfe, expected_mfe) == 0);
+    mfe_default_fold_free(mfe);
+    mfe_default_fold_free(expected_mfe);
+
+    validated_sequence_free(handle);
+    model_context_free(context);
+}
+
+TEST_CASE("view", "[fold]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+    const std::string rna = std::string("GGG") + sequence + "XX";
+
+    fold_output* expected = nullptr;
+    fold_output* output = nullptr;
+    size_t expected_size, size;
+    REQUIRE(fold(sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(fold_view(nullptr, rna.data() + 3, 20, output, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == expected_size);
+
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(strcmp(output[i].structure, expected[i].structure) == 0);
+        REQUIRE(output[i].probability == Approx(expected[i].probability));
+    }
+
+    fold_output_free(output, size);
+    fold_output_free(expected, expected_size);
+
+    char* expected_mfe = nullptr;
+    char* mfe = nullptr;
+    REQUIRE(mfe_default_fold(sequence, expected_mfe) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(mfe_default_fold_view(rna.data() + 3, 20, mfe) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(strcmp(mfe, expected_mfe) == 0);
+    mfe_default_fold_free(mfe);
+    mfe_default_fold_free(expected_mfe);
+
+    fold_ensemble* expected_ensemble = nullptr;
+    fold_ensemble* ensemble = nullptr;
+    REQUIRE(fold_with_ensemble(nullptr, sequence, 0.1f, expected, expected_size, expected_ensemble) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(fold_with_ensemble_view(nullptr, rna.data() + 3, 20, 0.1f, output, size, ensemble) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == expected_size);
+    REQUIRE(ensemble->energy == Approx(expected_ensemble->energy));
+    REQUIRE(ensemble->pair_count == expected_ensemble->pair_count);
+    REQUIRE(strcmp(ensemble->centroid, expected_ensemble->centroid) == 0);
+    fold_ensemble_free(ensemble);
+    fold_ensemble_free(expected_ensemble);
+    fold_output_free(output, size);
+    fold_output_free(expected, expected_size);
+
+    const fold_options options = { 3.0f, 5, 0.0f, FOLD_NORMALIZATION::FOLD_NORMALIZATION_SUBOPTIMAL };
+    float expected_captured, captured;
+    REQUIRE(fold_with_options(nullptr, sequence, options, expected, expected_size, expected_captured) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(fold_with_options_view(nullptr, rna.data() + 3, 20, options, output, size, captured) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == expected_size);
+    REQUIRE(captured == Approx(expected_captured));
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(strcmp(output[i].structure, expected[i].structure) == 0);
+        REQUIRE(output[i].probability == Approx(expected[i].probability));
+    }
+    fold_output_free(output, size);
+    fold_output_free(expected, expected_size);
+
+    REQUIRE(fold_view(nullptr, rna.data() + 3, 21, output, size) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(fold_with_ensemble_view(nullptr, rna.data() + 3, 21, 0.1f, output, size, ensemble) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(fold_with_ensemble_view(nullptr, rna.data() + 3, 20, 2.0f, output, size, ensemble) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(fold_with_options_view(nullptr, rna.data() + 3, 0, options, output, size, captured) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(mfe_default_fold_view(rna.data() + 3, 0, mfe) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(mfe_default_fold_view(nullptr, 20, mfe) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+}
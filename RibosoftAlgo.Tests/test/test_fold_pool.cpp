@@ -0,0 +1,177 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "functions.h"
+
+using namespace ribosoft;
+using Catch::Approx;
+
+TEST_CASE("pooling is opt-in", "[fold_pool]") {
+    fold_pool_clear();
+
+    fold_output* output = nullptr;
+    size_t size;
+    REQUIRE(fold("AUGUCUUAGGUGAUACGUGC", output, size) == R_SUCCESS::R_STATUS_OK);
+    fold_output_free(output, size);
+    REQUIRE(fold("AUGUCUUAGGUGAUACGUGC", output, size) == R_SUCCESS::R_STATUS_OK);
+    fold_output_free(output, size);
+
+    uint64_t hits, misses;
+    size_t bytes;
+    fold_pool_stats(hits, misses, bytes);
+    REQUIRE(hits == 0);
+    REQUIRE(bytes == 0);
+}
+
+TEST_CASE("pooled matrices", "[fold_pool]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+    fold_pool_configure(64 << 20);
+
+    fold_output* first = nullptr;
+    size_t first_size;
+    REQUIRE(fold(sequence, first, first_size) == R_SUCCESS::R_STATUS_OK);
+
+    uint64_t hits, misses;
+    size_t bytes;
+    fold_pool_stats(hits, misses, bytes);
+    REQUIRE(hits == 0);
+    REQUIRE(misses == 1);
+    REQUIRE(bytes > 0);
+
+    // same length, same model
+    fold_output* second = nullptr;
+    size_t second_size;
+    REQUIRE(fold("GCACGUAUCACCUAAGACAU", second, second_size) == R_SUCCESS::R_STATUS_OK);
+    fold_output_free(second, second_size);
+
+    REQUIRE(fold(sequence, second, second_size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(second_size == first_size);
+    for (size_t i = 0; i < first_size; ++i) {
+        REQUIRE(strcmp(second[i].structure, first[i].structure) == 0);
+        REQUIRE(second[i].probability == Approx(first[i].probability));
+    }
+    fold_output_free(second, second_size);
+
+    fold_pool_stats(hits, misses, bytes);
+    REQUIRE(hits == 2);
+    REQUIRE(misses == 1);
+
+    // the temperature must match too
+    model_context* context = nullptr;
+    REQUIRE(model_context_create(25.0f, 2, -1, 1.0f, 0.05f, context) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(fold_with_context(context, sequence, second, second_size) == R_SUCCESS::R_STATUS_OK);
+    fold_output_free(second, second_size);
+    model_context_free(context);
+
+    fold_pool_stats(hits, misses, bytes);
+    REQUIRE(hits == 2);
+    REQUIRE(misses == 2);
+
+    // and the span
+    REQUIRE(model_context_create(37.0f, 2, 10, 1.0f, 0.05f, context) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(fold_with_context(context, sequence, second, second_size) == R_SUCCESS::R_STATUS_OK);
+    fold_output_free(second, second_size);
+    model_context_free(context);
+
+    fold_pool_stats(hits, misses, bytes);
+    REQUIRE(hits == 2);
+    REQUIRE(misses == 3);
+
+    // other lengths do not share fold compounds
+    char* structure = nullptr;
+    REQUIRE(mfe_default_fold("AUGUCUUAGG", structure) == R_SUCCESS::R_STATUS_OK);
+    mfe_default_fold_free(structure);
+
+    fold_pool_stats(hits, misses, bytes);
+    REQUIRE(hits == 2);
+    REQUIRE(misses == 4);
+
+    // disabled
+    fold_pool_configure(0);
+    REQUIRE(fold(sequence, second, second_size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(second_size == first_size);
+    fold_output_free(second, second_size);
+    REQUIRE(fold(sequence, second, second_size) == R_SUCCESS::R_STATUS_OK);
+    fold_output_free(second, second_size);
+
+    fold_pool_stats(hits, misses, bytes);
+    REQUIRE(hits == 0);
+    REQUIRE(misses == 2);
+    REQUIRE(bytes == 0);
+
+    // matrices larger than the bound are not pooled
+    fold_pool_configure(16);
+    REQUIRE(fold(sequence, second, second_size) == R_SUCCESS::R_STATUS_OK);
+    fold_output_free(second, second_size);
+    fold_pool_stats(hits, misses, bytes);
+    REQUIRE(bytes == 0);
+
+    fold_pool_configure(0);
+    fold_output_free(first, first_size);
+}
+
+TEST_CASE("pooling across alternating contexts", "[fold_pool]") {
+    const char* sequences[] = { "AUGUCUUAGGUGAUACGUGC", "GCACGUAUCACCUAAGACAU", "GGGAAACCCAUAUAGGGAAA" };
+
+    model_context* warm = nullptr;
+    model_context* cold = nullptr;
+    model_context* no_dangles = nullptr;
+    REQUIRE(model_context_create(37.0f, 2, -1, 1.0f, 0.05f, warm) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(model_context_create(25.0f, 2, -1, 1.0f, 0.05f, cold) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(model_context_create(37.0f, 0, -1, 1.0f, 0.05f, no_dangles) == R_SUCCESS::R_STATUS_OK);
+    const model_context* contexts[] = { warm, cold, no_dangles };
+
+    std::vector<std::vector<std::pair<std::string, float>>> expected;
+    std::vector<float> expected_scores;
+    for (size_t round = 0; round < 2; ++round) {
+        fold_pool_configure(round == 0 ? 0 : 64 << 20);
+
+        size_t fold_index = 0;
+        for (size_t repeat = 0; repeat < 2; ++repeat) {
+            for (const char* sequence : sequences) {
+                for (const model_context* context : contexts) {
+                    fold_output* output = nullptr;
+                    size_t size;
+                    REQUIRE(fold_with_context(context, sequence, output, size) == R_SUCCESS::R_STATUS_OK);
+
+                    std::vector<std::pair<std::string, float>> structures;
+                    for (size_t i = 0; i < size; ++i) {
+                        structures.emplace_back(output[i].structure, output[i].probability);
+                    }
+                    fold_output_free(output, size);
+
+                    float score, max_distance, probability;
+                    REQUIRE(structure_score_with_context(context, sequence, "((((....))))........", score, max_distance, probability) == R_SUCCESS::R_STATUS_OK);
+
+                    if (round == 0) {
+                        expected.push_back(structures);
+                        expected_scores.push_back(score);
+                    } else {
+                        REQUIRE(structures.size() == expected[fold_index].size());
+                        for (size_t i = 0; i < structures.size(); ++i) {
+                            REQUIRE(structures[i].first == expected[fold_index][i].first);
+                            REQUIRE(structures[i].second == Approx(expected[fold_index][i].second));
+                        }
+                        REQUIRE(score == Approx(expected_scores[fold_index]));
+                    }
+                    ++fold_index;
+                }
+            }
+        }
+    }
+
+    // every model kept its own fold compound
+    uint64_t hits, misses;
+    size_t bytes;
+    fold_pool_stats(hits, misses, bytes);
+    REQUIRE(misses == 3);
+    REQUIRE(hits > 0);
+
+    fold_pool_configure(0);
+    model_context_free(warm);
+    model_context_free(cold);
+    model_context_free(no_dangles);
+}
@@ -0,0 +1,164 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "functions.h"
+
+using namespace ribosoft;
+using Catch::Approx;
+
+//! Long enough for several windows
+static const char* LOCAL_SEQUENCE = "GGGAAAUCCCAUGUCUUAGGUGAUACGUGCAAGCUUCGGCUUGCAUCGAUCGAUGCAAAGGCCUUUGCAUCG";
+
+namespace {
+
+struct local_consumer {
+    std::vector<std::string> structures;
+    std::vector<size_t> starts;
+    size_t limit = 0;
+
+    static int receive(size_t start, size_t length, const char* structure, float energy, void* data)
+    {
+        (void)energy;
+        local_consumer& consumer = *static_cast<local_consumer*>(data);
+        consumer.starts.push_back(start);
+        consumer.structures.emplace_back(structure, length);
+        return consumer.limit == 0 || consumer.structures.size() < consumer.limit;
+    }
+};
+
+struct unpaired_consumer {
+    std::vector<size_t> positions;
+    std::vector<std::vector<float>> probabilities;
+    size_t limit = 0;
+
+    static int receive(size_t position, const float* probabilities, size_t count, void* data)
+    {
+        unpaired_consumer& consumer = *static_cast<unpaired_consumer*>(data);
+        consumer.positions.push_back(position);
+        consumer.probabilities.emplace_back(probabilities, probabilities + count);
+        return consumer.limit == 0 || consumer.positions.size() < consumer.limit;
+    }
+};
+
+}
+
+TEST_CASE("local structures", "[local_fold]") {
+    const size_t length = strlen(LOCAL_SEQUENCE);
+
+    local_consumer consumer;
+    size_t size;
+    REQUIRE(local_fold_stream(nullptr, LOCAL_SEQUENCE, 30, 20, &local_consumer::receive, &consumer, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == consumer.structures.size());
+    REQUIRE(size > 0);
+
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(consumer.starts[i] + consumer.structures[i].size() <= length);
+        REQUIRE(consumer.structures[i].size() <= 30);
+    }
+
+    // stopping early
+    local_consumer first;
+    first.limit = 1;
+    REQUIRE(local_fold_stream(nullptr, LOCAL_SEQUENCE, 30, 20, &local_consumer::receive, &first, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == 1);
+    REQUIRE(first.structures.size() == 1);
+}
+
+TEST_CASE("local structure of the whole RNA", "[local_fold]") {
+    const size_t length = strlen(LOCAL_SEQUENCE);
+
+    char* structure = nullptr;
+    REQUIRE(local_fold(nullptr, LOCAL_SEQUENCE, 30, 20, structure) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(strlen(structure) == length);
+    REQUIRE(validate_structure(structure) == R_SUCCESS::R_STATUS_OK);
+
+    // no pair spans more than the maximum
+    std::vector<size_t> open;
+    for (size_t i = 0; i < length; ++i) {
+        if (structure[i] == '(') {
+            open.push_back(i);
+        } else if (structure[i] == ')') {
+            REQUIRE(i - open.back() < 20);
+            open.pop_back();
+        }
+    }
+
+    // usable for accessibility like a global fold
+    pairing_index* index = nullptr;
+    REQUIRE(pairing_index_create(structure, index) == R_SUCCESS::R_STATUS_OK);
+    pairing_index_free(index);
+
+    // a context of the default model details folds the same, its span overridden by the window's
+    model_context* context = nullptr;
+    REQUIRE(model_context_create(37.0f, 2, 10, 1.0f, 0.05f, context) == R_SUCCESS::R_STATUS_OK);
+    char* in_context = nullptr;
+    REQUIRE(local_fold(context, LOCAL_SEQUENCE, 30, 20, in_context) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(strcmp(in_context, structure) == 0);
+    mfe_default_fold_free(in_context);
+    model_context_free(context);
+
+    // the same RNA given as a range of a longer string
+    const std::string rna = std::string("GG") + LOCAL_SEQUENCE + "XX";
+    char* view = nullptr;
+    REQUIRE(local_fold_view(nullptr, rna.data() + 2, length, 30, 20, view) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(strcmp(view, structure) == 0);
+    mfe_default_fold_free(view);
+
+    REQUIRE(local_fold_view(nullptr, rna.data() + 2, length + 1, 30, 20, view) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(local_fold_view(nullptr, nullptr, length, 30, 20, view) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    mfe_default_fold_free(structure);
+}
+
+TEST_CASE("local unpaired probabilities", "[local_fold]") {
+    const size_t length = strlen(LOCAL_SEQUENCE);
+
+    unpaired_consumer consumer;
+    REQUIRE(local_unpaired_stream(nullptr, LOCAL_SEQUENCE, 30, 20, 8, &unpaired_consumer::receive, &consumer) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(consumer.positions.size() == length);
+
+    for (size_t i = 0; i < consumer.positions.size(); ++i) {
+        REQUIRE(consumer.positions[i] == i);
+
+        const std::vector<float>& probabilities = consumer.probabilities[i];
+        REQUIRE(probabilities.size() == std::min<size_t>(8, i + 1));
+        for (size_t u = 0; u < probabilities.size(); ++u) {
+            REQUIRE(probabilities[u] >= 0.0f);
+            REQUIRE(probabilities[u] <= 1.0f);
+
+            // a longer stretch is never more likely to be unpaired
+            if (u > 0) {
+                REQUIRE(probabilities[u] <= probabilities[u - 1] + 0.0001f);
+            }
+        }
+    }
+
+    unpaired_consumer first;
+    first.limit = 3;
+    REQUIRE(local_unpaired_stream(nullptr, LOCAL_SEQUENCE, 30, 20, 8, &unpaired_consumer::receive, &first) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(first.positions.size() == 3);
+}
+
+TEST_CASE("invalid windows", "[local_fold]") {
+    char* structure = nullptr;
+    REQUIRE(local_fold(nullptr, LOCAL_SEQUENCE, 3, 0, structure) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(local_fold(nullptr, LOCAL_SEQUENCE, 30, 40, structure) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(local_fold(nullptr, LOCAL_SEQUENCE, 30, 2, structure) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(local_fold(nullptr, "AUGX", 30, 0, structure) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+
+    size_t size;
+    REQUIRE(local_fold_stream(nullptr, LOCAL_SEQUENCE, 30, 20, nullptr, nullptr, size) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    unpaired_consumer consumer;
+    REQUIRE(local_unpaired_stream(nullptr, LOCAL_SEQUENCE, 30, 20, 0, &unpaired_consumer::receive, &consumer) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(local_unpaired_stream(nullptr, LOCAL_SEQUENCE, 30, 20, 31, &unpaired_consumer::receive, &consumer) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(local_unpaired_stream(nullptr, LOCAL_SEQUENCE, 30, 20, 8, nullptr, nullptr) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(consumer.positions.empty());
+
+    // a window longer than the RNA is the whole RNA
+    REQUIRE(local_fold(nullptr, "GGGAAAUCCC", 30, 0, structure) == R_SUCCESS::R_STATUS_OK);
+    mfe_default_fold_free(structure);
+}
@@ -0,0 +1,166 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cstring>
+
+#include "functions.h"
+
+using namespace ribosoft;
+using Catch::Approx;
+
+TEST_CASE("default conditions", "[model_context]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+
+    // 37 degrees and dangles 2 are ViennaRNA's defaults
+    model_context* context = nullptr;
+    REQUIRE(model_context_create(37.0f, 2, -1, 1.0f, 0.05f, context) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(context != nullptr);
+
+    fold_output* expected = nullptr;
+    size_t expected_size;
+    REQUIRE(fold(sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+
+    fold_output* output = nullptr;
+    size_t size;
+    REQUIRE(fold_with_context(context, sequence, output, size) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(size == expected_size);
+    for (size_t i = 0; i < size; ++i) {
+        REQUIRE(strcmp(output[i].structure, expected[i].structure) == 0);
+        REQUIRE(output[i].probability == Approx(expected[i].probability));
+    }
+    fold_output_free(output, size);
+    fold_output_free(expected, expected_size);
+
+    char* mfe_expected = nullptr;
+    char* mfe = nullptr;
+    REQUIRE(mfe_default_fold(sequence, mfe_expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(mfe_fold_with_context(context, sequence, mfe) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(strcmp(mfe, mfe_expected) == 0);
+    mfe_default_fold_free(mfe);
+    mfe_default_fold_free(mfe_expected);
+
+    const char* ideal = ".((((......)))).....";
+    float weighted, max_distance, probability;
+    float context_weighted, context_max_distance, context_probability;
+    REQUIRE(structure_score(sequence, ideal, weighted, max_distance, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_score_with_context(context, sequence, ideal, context_weighted, context_max_distance, context_probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(context_weighted == Approx(weighted));
+    REQUIRE(context_max_distance == Approx(max_distance));
+    REQUIRE(context_probability == Approx(probability));
+
+    // concentrations and target temperature of the context
+    float temp, context_temp;
+    REQUIRE(anneal("AAUUUCCCCGGGGG", "0123abxy..BXYZ", 1.0f, 0.05f, 37.0f, temp) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(anneal_with_context(context, "AAUUUCCCCGGGGG", "0123abxy..BXYZ", context_temp) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(context_temp == Approx(temp));
+
+    model_context_free(context);
+}
+
+TEST_CASE("assay temperature", "[model_context]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+
+    model_context* cold = nullptr;
+    model_context* warm = nullptr;
+    REQUIRE(model_context_create(25.0f, 2, -1, 1.0f, 0.05f, cold) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(model_context_create(60.0f, 2, -1, 1.0f, 0.05f, warm) == R_SUCCESS::R_STATUS_OK);
+
+    // both fold, and the folds are independent of each other
+    for (int repeat = 0; repeat < 2; ++repeat) {
+        for (model_context* context : { cold, warm }) {
+            fold_output* output = nullptr;
+            size_t size;
+            REQUIRE(fold_with_context(context, sequence, output, size) == R_SUCCESS::R_STATUS_OK);
+            REQUIRE(size > 0);
+
+            float total = 0.0f;
+            for (size_t i = 0; i < size; ++i) {
+                total += output[i].probability;
+            }
+            REQUIRE(total <= 1.0001f);
+            fold_output_free(output, size);
+        }
+    }
+
+    model_context_free(cold);
+    model_context_free(warm);
+}
+
+TEST_CASE("context of the batched and candidate exports", "[model_context]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+    const char* ideal = ".((((......)))).....";
+
+    model_context* context = nullptr;
+    REQUIRE(model_context_create(25.0f, 2, -1, 0.5f, 0.1f, context) == R_SUCCESS::R_STATUS_OK);
+
+    fold_output* expected = nullptr;
+    size_t expected_size;
+    REQUIRE(fold_with_context(context, sequence, expected, expected_size) == R_SUCCESS::R_STATUS_OK);
+
+    const char* sequences[] = { sequence };
+    fold_output* outputs[1];
+    size_t sizes[1];
+    R_STATUS statuses[1];
+    REQUIRE(fold_batch(context, sequences, 1, 1, outputs, sizes, statuses) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(statuses[0] == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(sizes[0] == expected_size);
+    for (size_t i = 0; i < expected_size; ++i) {
+        REQUIRE(strcmp(outputs[0][i].structure, expected[i].structure) == 0);
+        REQUIRE(outputs[0][i].probability == Approx(expected[i].probability));
+    }
+    fold_batch_free(outputs, sizes, 1);
+
+    fold_arena* arena = nullptr;
+    REQUIRE(fold_arena_create(context, sequence, arena) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(arena->count == expected_size);
+    REQUIRE(arena->probabilities[0] == Approx(expected[0].probability));
+    fold_arena_free(arena);
+    fold_output_free(expected, expected_size);
+
+    float weighted, max_distance, probability;
+    float batch_weighted, batch_max_distance, batch_probability;
+    const char* ideals[] = { ideal };
+    REQUIRE(structure_score_with_context(context, sequence, ideal, weighted, max_distance, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_score_batch(context, sequences, ideals, 1, 1, &batch_weighted, &batch_max_distance, &batch_probability, statuses) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(statuses[0] == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(batch_weighted == Approx(weighted));
+    REQUIRE(batch_max_distance == Approx(max_distance));
+    REQUIRE(batch_probability == Approx(probability));
+
+    // the conditions of the context replace the arguments, which would be rejected here
+    const int cutsites[] = { 0 };
+    float temperature, scores[1];
+    float context_temperature, context_scores[1];
+    REQUIRE(candidate_score(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", "((((......)))).", cutsites, 1, 0.5f, 0.1f, 25.0f, temperature, scores) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(candidate_score(context, "CAACUGCAUGUGAUG", "cba987654..3210", "((((......)))).", cutsites, 1, 0.0f, 0.0f, 0.0f, context_temperature, context_scores) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(context_temperature == Approx(temperature));
+    REQUIRE(context_scores[0] == Approx(scores[0]));
+
+    model_context_free(context);
+}
+
+TEST_CASE("invalid conditions", "[model_context]") {
+    model_context* context = nullptr;
+    REQUIRE(model_context_create(-300.0f, 2, -1, 1.0f, 0.05f, context) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(context == nullptr);
+    REQUIRE(model_context_create(-273.15f, 2, -1, 1.0f, 0.05f, context) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(model_context_create(200.0f, 2, -1, 1.0f, 0.05f, context) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(model_context_create(37.0f, 2, 3, 1.0f, 0.05f, context) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(model_context_create(37.0f, 4, -1, 1.0f, 0.05f, context) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(model_context_create(37.0f, 2, -1, 0.0f, 0.05f, context) == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
+    REQUIRE(model_context_create(37.0f, 2, -1, 1.0f, 0.0f, context) == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
+    REQUIRE(context == nullptr);
+
+    fold_output* output = nullptr;
+    size_t size;
+    REQUIRE(fold_with_context(nullptr, "AUGC", output, size) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    char* structure = nullptr;
+    REQUIRE(mfe_fold_with_context(nullptr, "AUGC", structure) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    float temp;
+    REQUIRE(anneal_with_context(nullptr, "AAUU", "0123", temp) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    REQUIRE(model_context_create(37.0f, 2, 100, 1.0f, 0.05f, context) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(fold_with_context(context, "AUGX", output, size) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    model_context_free(context);
+}
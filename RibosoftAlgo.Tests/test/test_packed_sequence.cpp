@@ -0,0 +1,82 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <string>
+#include <vector>
+
+#include "functions.h"
+
+using namespace ribosoft;
+using Catch::Approx;
+
+TEST_CASE("pack and unpack", "[packed_sequence]") {
+    // long enough to span several words, with windows across word boundaries
+    std::string rna;
+    for (size_t i = 0; i < 150; ++i) {
+        rna += "ACGU"[(i * 7 + i / 5) % 4];
+    }
+
+    packed_sequence* packed = nullptr;
+    REQUIRE(packed_sequence_create(rna.c_str(), packed) == R_SUCCESS::R_STATUS_OK);
+
+    std::vector<char> buffer(rna.size() + 1);
+    REQUIRE(packed_sequence_unpack(packed, 0, rna.size(), buffer.data()) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(std::string(buffer.data()) == rna);
+
+    for (size_t start = 0; start < rna.size(); start += 3) {
+        for (size_t length = 1; length <= 32 && start + length <= rna.size(); ++length) {
+            REQUIRE(packed_sequence_unpack(packed, start, length, buffer.data()) == R_SUCCESS::R_STATUS_OK);
+            REQUIRE(std::string(buffer.data()) == rna.substr(start, length));
+
+            // 2 bits per nucleotide, A = 0, C = 1, G = 2, U = 3, the first one most significant
+            uint64_t expected = 0;
+            for (size_t i = 0; i < length; ++i) {
+                expected = (expected << 2) | std::string("ACGU").find(rna[start + i]);
+            }
+
+            uint64_t window;
+            REQUIRE(packed_sequence_window(packed, start, length, window) == R_SUCCESS::R_STATUS_OK);
+            REQUIRE(window == expected);
+        }
+    }
+
+    packed_sequence_free(packed);
+}
+
+TEST_CASE("invalid packed sequence parameters", "[packed_sequence]") {
+    packed_sequence* packed = nullptr;
+    REQUIRE(packed_sequence_create("AUGCTAUAGC", packed) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(packed == nullptr);
+    REQUIRE(packed_sequence_create((std::string(40, 'A') + "a").c_str(), packed) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(packed_sequence_create("", packed) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(packed_sequence_create(nullptr, packed) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    REQUIRE(packed_sequence_create("AUGCAUGC", packed) == R_SUCCESS::R_STATUS_OK);
+
+    uint64_t window;
+    char buffer[16];
+    REQUIRE(packed_sequence_window(nullptr, 0, 4, window) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(packed_sequence_window(packed, 6, 3, window) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(packed_sequence_window(packed, 0, 0, window) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(packed_sequence_unpack(packed, 4, 5, buffer) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(packed_sequence_unpack(packed, 0, 4, nullptr) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    packed_sequence_free(packed);
+}
+
+TEST_CASE("melting temperature of long packed sequences", "[packed_sequence]") {
+    // arms longer than a register, read in place on a target across word boundaries
+    const std::string rna = "GGGAUCCAUGCAUGGCCAUAGCUAGCAUCGAUGCAUGACGUCAUGCAUCGAUGCUAGCUAUGGCCAUGCAUGGAUCCAA";
+    target_context* context = nullptr;
+    REQUIRE(target_context_create(rna.c_str(), context) == R_SUCCESS::R_STATUS_OK);
+
+    for (size_t start : { 0, 3, 29, 31 }) {
+        for (size_t length : { 33, 40, 45 }) {
+            float expected, temp;
+            REQUIRE(melting_temperature(rna.substr(start, length).c_str(), 1.0f, 0.05f, expected) == R_SUCCESS::R_STATUS_OK);
+            REQUIRE(target_context_melting(context, start, length, 1.0f, 0.05f, temp) == R_SUCCESS::R_STATUS_OK);
+            REQUIRE(temp == Approx(expected));
+        }
+    }
+
+    target_context_free(context);
+}
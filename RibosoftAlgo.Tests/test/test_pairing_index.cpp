@@ -0,0 +1,78 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <string>
+
+#include "functions.h"
+
+using namespace ribosoft;
+using Catch::Approx;
+
+TEST_CASE("unpaired ranges", "[pairing_index]") {
+    // paired positions around the 64-bit word boundaries
+    std::string structure(200, '.');
+    for (size_t i : { 0, 63, 64, 127, 150, 199 }) {
+        structure[i] = i < 100 ? '(' : ')';
+    }
+
+    pairing_index* index = nullptr;
+    REQUIRE(pairing_index_create(structure.c_str(), index) == R_SUCCESS::R_STATUS_OK);
+
+    for (size_t start = 0; start <= structure.length(); start += 7) {
+        for (size_t length = 0; start + length <= structure.length(); length += 5) {
+            bool unpaired = false;
+            REQUIRE(pairing_index_unpaired(index, start, length, unpaired) == R_SUCCESS::R_STATUS_OK);
+            REQUIRE(unpaired == (structure.substr(start, length).find_first_not_of('.') == std::string::npos));
+        }
+    }
+
+    bool unpaired = false;
+    REQUIRE(pairing_index_unpaired(index, 1, 62, unpaired) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(unpaired);
+    REQUIRE(pairing_index_unpaired(index, 1, 63, unpaired) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE_FALSE(unpaired);
+    REQUIRE(pairing_index_unpaired(index, 151, 48, unpaired) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(unpaired);
+
+    pairing_index_free(index);
+}
+
+TEST_CASE("invalid pairing index inputs", "[pairing_index]") {
+    pairing_index* index = nullptr;
+    REQUIRE(pairing_index_create("", index) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(pairing_index_create("..(x)..", index) == R_APPLICATION_ERROR::R_INVALID_STRUCT_ELEMENT);
+    REQUIRE(index == nullptr);
+
+    REQUIRE(pairing_index_create("..()..", index) == R_SUCCESS::R_STATUS_OK);
+
+    bool unpaired = false;
+    REQUIRE(pairing_index_unpaired(index, 4, 3, unpaired) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(pairing_index_unpaired(index, 7, 0, unpaired) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(pairing_index_unpaired(nullptr, 0, 1, unpaired) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    pairing_index_free(index);
+}
+
+TEST_CASE("candidate score on indexed RNA", "[pairing_index]") {
+    const std::string rna = "...((()((.)).)..........()......";
+    const int cutsites[] = { 0, 15, 3, 17 };
+
+    pairing_index* index = nullptr;
+    REQUIRE(pairing_index_create(rna.c_str(), index) == R_SUCCESS::R_STATUS_OK);
+
+    float expected_temperature, temperature;
+    float expected[4], scores[4];
+    REQUIRE(candidate_score(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", rna.c_str(), cutsites, 4, 1.0f, 0.5f, 22.0f, expected_temperature, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(candidate_score_indexed(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", index, cutsites, 4, 1.0f, 0.5f, 22.0f, temperature, scores) == R_SUCCESS::R_STATUS_OK);
+
+    REQUIRE(temperature == Approx(expected_temperature));
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(scores[i] == Approx(expected[i]));
+    }
+    REQUIRE(scores[1] == 0.0f);
+
+    const int outside[] = { 18 };
+    REQUIRE(candidate_score_indexed(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", index, outside, 1, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(candidate_score_indexed(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", nullptr, cutsites, 4, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    pairing_index_free(index);
+}
@@ -1,5 +1,8 @@
 #include <catch2/catch_amalgamated.hpp>
 
+#include <algorithm>
+#include <cstring>
+#include <string>
 
 #include "functions.h"
 
@@ -28,6 +31,23 @@ TEST_CASE("not equal structures", "[structure]") {
     REQUIRE(dist == 6.0f);
 }
 
+TEST_CASE("unpaired and paired relabelling", "[structure]") {
+    // a childless pair becomes an unpaired base for 1, as with ViennaRNA's UsualCost
+    float dist;
+    REQUIRE(structure("()", "..", dist) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(dist == 2.0f);
+
+    REQUIRE(structure("(())", "(..)", dist) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(dist == 2.0f);
+
+    REQUIRE(structure("()()", "....", dist) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(dist == 4.0f);
+
+    // a pair with children is still deleted (2) rather than relabelled
+    REQUIRE(structure("(...)", ".....", dist) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(dist == 4.0f);
+}
+
 TEST_CASE("not equal length structures", "[structure]") {
     float dist;
     R_STATUS status = structure("..()..", "((.))", dist);
@@ -50,4 +70,327 @@ TEST_CASE("invalid structures", "[structure]") {
 
     status = structure("..()()()", "(()()))", dist);
     REQUIRE(status == R_APPLICATION_ERROR::R_BAD_PAIR_MATCH);
-}
\ No newline at end of file
+}
+
+TEST_CASE("long structures", "[structure]") {
+    // longer than 255, where indices used to wrap
+    const std::string candidate = "(" + std::string(300, '.') + ")";
+    const std::string ideal(302, '.');
+
+    float dist;
+    REQUIRE(structure(candidate.c_str(), ideal.c_str(), dist) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(dist == Approx(4.0f));
+
+    REQUIRE(structure((candidate + ")").c_str(), (ideal + ".").c_str(), dist) == R_APPLICATION_ERROR::R_BAD_PAIR_MATCH);
+}
+
+TEST_CASE("concurrent structures", "[structure]") {
+    const char* candidates[] = { "..()..", "(.().)()", "((..))", "......" };
+    const char* ideals[] = { "((..))", "...()().", "((..))", "(....)" };
+
+    float expected[4];
+    for (int i = 0; i < 4; ++i) {
+        REQUIRE(structure(candidates[i], ideals[i], expected[i]) == R_SUCCESS::R_STATUS_OK);
+    }
+
+    int mismatches = 0;
+    #pragma omp parallel for reduction(+:mismatches)
+    for (int i = 0; i < 4000; ++i) {
+        float dist;
+        if (structure(candidates[i % 4], ideals[i % 4], dist) != R_SUCCESS::R_STATUS_OK || dist != expected[i % 4]) {
+            ++mismatches;
+        }
+    }
+
+    REQUIRE(mismatches == 0);
+}
+
+TEST_CASE("ideal structure handle", "[structure]") {
+    structure_ideal* handle = nullptr;
+    R_STATUS status = structure_ideal_create("((..))", handle);
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+
+    float dist;
+    status = structure_ideal_compare(handle, "..()..", dist);
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(dist == 8.0f);
+
+    status = structure_ideal_compare(handle, "((..))", dist);
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(dist == 0.0f);
+
+    status = structure_ideal_compare(handle, "..)(..", dist);
+    REQUIRE(status == R_APPLICATION_ERROR::R_BAD_PAIR_MATCH);
+
+    status = structure_ideal_compare(handle, "((.))", dist);
+    REQUIRE(status == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+
+    structure_ideal_free(handle);
+
+    status = structure_ideal_create("(()()))", handle);
+    REQUIRE(status == R_APPLICATION_ERROR::R_BAD_PAIR_MATCH);
+
+    status = structure_ideal_compare(nullptr, "..", dist);
+    REQUIRE(status == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+}
+
+TEST_CASE("structure score matches fold and structure", "[structure]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+    const char* ideal = "..((((........))))..";
+
+    fold_output* output = nullptr;
+    size_t size;
+    REQUIRE(fold(sequence, output, size) == R_SUCCESS::R_STATUS_OK);
+
+    float expected_weighted = 0.0f;
+    float expected_max = 0.0f;
+    float expected_probability = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+        float dist;
+        REQUIRE(structure(output[i].structure, ideal, dist) == R_SUCCESS::R_STATUS_OK);
+        expected_weighted += dist * output[i].probability;
+        expected_max = std::max(expected_max, dist);
+        expected_probability += output[i].probability;
+    }
+    fold_output_free(output, size);
+
+    float weighted, max, probability;
+    R_STATUS status = structure_score(sequence, ideal, weighted, max, probability);
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(weighted == Approx(expected_weighted));
+    REQUIRE(max == expected_max);
+    REQUIRE(probability == Approx(expected_probability));
+}
+
+TEST_CASE("structure score batch", "[structure]") {
+    const char* sequences[] = { "AUGUCUUAGGUGAUACGUGC", "AUGUCUUAGGUGAUACGUGC", "AUGUCUUAGGUGAUACGUG" };
+    const char* ideals[] = { "..((((........))))..", ".)(.................", "..((((........))))..", };
+    float weighted[3], max[3], probability[3];
+    R_STATUS statuses[3];
+    R_STATUS status = structure_score_batch(nullptr, sequences, ideals, 3, 2, weighted, max, probability, statuses);
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+
+    float expected_weighted, expected_max, expected_probability;
+    REQUIRE(structure_score(sequences[0], ideals[0], expected_weighted, expected_max, expected_probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(statuses[0] == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(weighted[0] == expected_weighted);
+    REQUIRE(max[0] == expected_max);
+    REQUIRE(probability[0] == expected_probability);
+
+    REQUIRE(statuses[1] == R_APPLICATION_ERROR::R_BAD_PAIR_MATCH);
+    REQUIRE(statuses[2] == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+}
+
+TEST_CASE("ensemble defect matches base pair probabilities", "[structure]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+    const char* ideals[] = { ".((((......)))).....", "....................", "((((((....))))))...." };
+    const size_t length = strlen(sequence);
+
+    fold_output* output = nullptr;
+    size_t size;
+    fold_ensemble* ensemble = nullptr;
+    REQUIRE(fold_with_ensemble(nullptr, sequence, 0.0f, output, size, ensemble) == R_SUCCESS::R_STATUS_OK);
+
+    for (const char* ideal : ideals) {
+        // n - sum(u_i, i unpaired in ideal) - sum(2 * p_ij, (i, j) paired in ideal)
+        double expected = static_cast<double>(length);
+        for (size_t i = 0; i < length; ++i) {
+            if (ideal[i] == '.') {
+                expected -= ensemble->unpaired[i];
+            }
+        }
+        for (size_t k = 0; k < ensemble->pair_count; ++k) {
+            const fold_pair& pair = ensemble->pairs[k];
+            if (ideal[pair.i] == '(' && ideal[pair.j] == ')') {
+                int depth = 0;
+                bool partners = true;
+                for (int x = pair.i; x <= pair.j; ++x) {
+                    depth += ideal[x] == '(' ? 1 : ideal[x] == ')' ? -1 : 0;
+                    if (depth == 0 && x < pair.j) {
+                        partners = false;
+                        break;
+                    }
+                }
+                if (partners) {
+                    expected -= 2.0 * pair.probability;
+                }
+            }
+        }
+
+        float defect = -1.0f;
+        REQUIRE(structure_ensemble_defect(nullptr, sequence, ideal, defect) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(defect == Approx(expected).margin(0.001));
+        REQUIRE(defect >= 0.0f);
+        REQUIRE(defect <= static_cast<float>(length));
+    }
+
+    fold_ensemble_free(ensemble);
+    fold_output_free(output, size);
+}
+
+TEST_CASE("structure score mode", "[structure]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+    const char* ideal = ".((((......)))).....";
+
+    // the default conditions, with the method selected per context
+    model_context* context = nullptr;
+    REQUIRE(model_context_create(37.0f, 2, -1, 1.0f, 0.05f, context) == R_SUCCESS::R_STATUS_OK);
+
+    float defect;
+    REQUIRE(structure_ensemble_defect(nullptr, sequence, ideal, defect) == R_SUCCESS::R_STATUS_OK);
+
+    float subopt_weighted, subopt_max, subopt_probability;
+    REQUIRE(structure_score(sequence, ideal, subopt_weighted, subopt_max, subopt_probability) == R_SUCCESS::R_STATUS_OK);
+
+    float weighted, max, probability;
+    REQUIRE(structure_score_with_context(context, sequence, ideal, weighted, max, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(weighted == Approx(subopt_weighted));
+    REQUIRE(max == subopt_max);
+
+    REQUIRE(model_context_set_structure_score_mode(context, STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_ENSEMBLE_DEFECT) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_score_with_context(context, sequence, ideal, weighted, max, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(weighted == Approx(defect));
+    REQUIRE(max == 20.0f);
+    REQUIRE(probability == 1.0f);
+
+    // a score without the context keeps the suboptimal method
+    REQUIRE(structure_score(sequence, ideal, weighted, max, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(weighted == Approx(subopt_weighted));
+    REQUIRE(max == subopt_max);
+
+    // normalized by the band, as fold_with_options with FOLD_NORMALIZATION_SUBOPTIMAL
+    fold_options options{ 5.0f, 0, 0.0f, FOLD_NORMALIZATION::FOLD_NORMALIZATION_SUBOPTIMAL };
+    fold_output* output = nullptr;
+    size_t size = 0;
+    float captured;
+    REQUIRE(fold_with_options(nullptr, sequence, options, output, size, captured) == R_SUCCESS::R_STATUS_OK);
+
+    float expected_weighted = 0.0f;
+    for (size_t i = 0; i < size; ++i) {
+        float dist;
+        REQUIRE(structure(output[i].structure, ideal, dist) == R_SUCCESS::R_STATUS_OK);
+        expected_weighted += dist * output[i].probability;
+    }
+    fold_output_free(output, size);
+
+    REQUIRE(model_context_set_structure_score_mode(context, STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_SUBOPT_BAND) == R_SUCCESS::R_STATUS_OK);
+    const char* sequences[] = { sequence };
+    const char* ideals[] = { ideal };
+    R_STATUS statuses[1];
+    R_STATUS status = structure_score_batch(context, sequences, ideals, 1, 1, &weighted, &max, &probability, statuses);
+
+    REQUIRE(status == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(statuses[0] == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(weighted == Approx(expected_weighted));
+    REQUIRE(max == subopt_max);
+    REQUIRE(probability == Approx(1.0f));
+
+    REQUIRE(model_context_set_structure_score_mode(context, static_cast<STRUCTURE_SCORE_MODE>(7)) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(model_context_set_structure_score_mode(nullptr, STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_SUBOPT) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(structure_ensemble_defect(nullptr, sequence, "((..", defect) == R_APPLICATION_ERROR::R_BAD_PAIR_MATCH);
+    REQUIRE(structure_ensemble_defect(nullptr, sequence, "....", defect) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+
+    model_context_free(context);
+}
+
+TEST_CASE("validated structures and sequences", "[structure]") {
+    const char* sequence = "AUGUCUUAGGUGAUACGUGC";
+    const char* ideal = "..((((........))))..";
+
+    structure_ideal* handle = nullptr;
+    REQUIRE(structure_ideal_create(ideal, handle) == R_SUCCESS::R_STATUS_OK);
+
+    validated_structure* candidate = nullptr;
+    REQUIRE(validated_structure_create(".((((......)))).....", candidate) == R_SUCCESS::R_STATUS_OK);
+
+    float expected, distance;
+    REQUIRE(structure(".((((......)))).....", ideal, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_ideal_compare_validated(handle, candidate, distance) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(distance == expected);
+    validated_structure_free(candidate);
+
+    // pseudoknot brackets count as unpaired, as in the dot-bracket comparison
+    REQUIRE(validated_structure_create(".((({{...)))...}}...", candidate) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure(".((({{...)))...}}...", ideal, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_ideal_compare_validated(handle, candidate, distance) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(distance == expected);
+    REQUIRE(structure(".(((.....)))........", ideal, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(distance == expected);
+    validated_structure_free(candidate);
+
+    REQUIRE(validated_structure_create("()", candidate) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_ideal_compare_validated(handle, candidate, distance) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+    validated_structure_free(candidate);
+
+    validated_sequence* design = nullptr;
+    REQUIRE(validated_sequence_create(sequence, design) == R_SUCCESS::R_STATUS_OK);
+
+    float expected_weighted, expected_max, expected_probability;
+    float weighted, max, probability;
+    REQUIRE(structure_score(sequence, ideal, expected_weighted, expected_max, expected_probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_score_validated(nullptr, design, handle, weighted, max, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(weighted == Approx(expected_weighted));
+    REQUIRE(max == expected_max);
+    REQUIRE(probability == Approx(expected_probability));
+
+    // in a model context, scored with its method
+    model_context* context = nullptr;
+    REQUIRE(model_context_create(25.0f, 2, -1, 1.0f, 0.05f, context) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(model_context_set_structure_score_mode(context, STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_ENSEMBLE_DEFECT) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_score_with_context(context, sequence, ideal, expected_weighted, expected_max, expected_probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_score_validated(context, design, handle, weighted, max, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(weighted == Approx(expected_weighted));
+    REQUIRE(max == expected_max);
+    REQUIRE(probability == Approx(expected_probability));
+
+    float view_weighted, view_max, view_probability;
+    REQUIRE(structure_score_view(context, sequence, strlen(sequence), ideal, strlen(ideal), view_weighted, view_max, view_probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(view_weighted == Approx(expected_weighted));
+    REQUIRE(view_max == expected_max);
+    REQUIRE(view_probability == Approx(expected_probability));
+    model_context_free(context);
+
+    REQUIRE(structure_score_validated(nullptr, nullptr, handle, weighted, max, probability) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    validated_sequence_free(design);
+    structure_ideal_free(handle);
+}
+
+TEST_CASE("structure views", "[structure]") {
+    // candidate and ideal side by side, neither terminated where it ends
+    const std::string structures = ".((((......)))).....((((......))))..";
+    const char* candidate = structures.data();
+    const char* ideal = structures.data() + 16;
+
+    float expected, distance;
+    REQUIRE(structure(structures.substr(0, 20).c_str(), structures.substr(16, 20).c_str(), expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_view(candidate, 20, ideal, 20, distance) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(distance == expected);
+
+    REQUIRE(structure_view(candidate, 20, ideal, 18, distance) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+    REQUIRE(structure_view(candidate, 14, ideal, 20, distance) == R_APPLICATION_ERROR::R_BAD_PAIR_MATCH);
+    REQUIRE(structure_view(candidate, 0, ideal, 20, distance) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(structure_view(nullptr, 20, ideal, 20, distance) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    // design sequence and ideal structure as ranges of longer strings
+    const std::string sequences = "GGAUGUCUUAGGUGAUACGUGCXX";
+    const char* sequence = sequences.data() + 2;
+
+    float weighted, max_distance, probability;
+    float view_weighted, view_max_distance, view_probability;
+    REQUIRE(structure_score(sequences.substr(2, 20).c_str(), structures.substr(16, 20).c_str(), weighted, max_distance, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_score_view(nullptr, sequence, 20, ideal, 20, view_weighted, view_max_distance, view_probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(view_weighted == Approx(weighted));
+    REQUIRE(view_max_distance == Approx(max_distance));
+    REQUIRE(view_probability == Approx(probability));
+
+    float defect, view_defect;
+    REQUIRE(structure_ensemble_defect(nullptr, sequences.substr(2, 20).c_str(), structures.substr(16, 20).c_str(), defect) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(structure_ensemble_defect_view(nullptr, sequence, 20, ideal, 20, view_defect) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(view_defect == Approx(defect));
+
+    REQUIRE(structure_score_view(nullptr, sequence, 21, ideal, 20, view_weighted, view_max_distance, view_probability) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(structure_score_view(nullptr, sequence, 20, ideal, 18, view_weighted, view_max_distance, view_probability) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+    REQUIRE(structure_ensemble_defect_view(nullptr, sequence, 20, nullptr, 20, view_defect) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(structure_ensemble_defect_view(nullptr, sequence, 20, ideal, 14, view_defect) == R_APPLICATION_ERROR::R_BAD_PAIR_MATCH);
+}
@@ -0,0 +1,73 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cmath>
+
+#include "functions.h"
+
+using namespace ribosoft;
+using Catch::Approx;
+
+TEST_CASE("anneal with template", "[substrate_template]") {
+    substrate_template* handle = nullptr;
+    REQUIRE(substrate_template_create("0123abxy..BXYZ", handle) == R_SUCCESS::R_STATUS_OK);
+
+    for (const char* sequence : { "AAUUUCCCCGGGGG", "GCAUCGAUCGGCUA", "CAGUACGUCCAGUA" }) {
+        float expected, temp;
+        REQUIRE(anneal(sequence, "0123abxy..BXYZ", 1.0f, 0.05f, 22.0f, expected) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(substrate_template_anneal(handle, sequence, 1.0f, 0.05f, 22.0f, temp) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(temp == Approx(expected));
+    }
+
+    substrate_template_free(handle);
+}
+
+TEST_CASE("accessibility with template", "[substrate_template]") {
+    substrate_template* handle = nullptr;
+    REQUIRE(substrate_template_create("cba987654..3210", handle) == R_SUCCESS::R_STATUS_OK);
+
+    float score = -1.0f;
+    REQUIRE(substrate_template_accessibility(handle, "CAACUGCAUGUGAUG", ".........()....", 1.0f, 0.5f, 22.0f, score) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(score == 0.0f);
+
+    float expected;
+    REQUIRE(accessibility("CAACUGCAUGUGAUG", "cba987654..3210", "...((()((.)).).", 1.0f, 0.5f, 22.0f, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(substrate_template_accessibility(handle, "CAACUGCAUGUGAUG", "...((()((.)).).", 1.0f, 0.5f, 22.0f, score) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(score == Approx(expected));
+
+    substrate_template_free(handle);
+}
+
+TEST_CASE("template arms of length 1 are ignored", "[substrate_template]") {
+    substrate_template* handle = nullptr;
+    REQUIRE(substrate_template_create("0.12.3", handle) == R_SUCCESS::R_STATUS_OK);
+
+    float expected, temp;
+    REQUIRE(anneal("GCAUCG", "0.12.3", 1.0f, 0.05f, 22.0f, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(substrate_template_anneal(handle, "GCAUCG", 1.0f, 0.05f, 22.0f, temp) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temp == Approx(expected));
+
+    float arm;
+    REQUIRE(melting_temperature("AU", 1.0f, 0.05f, arm) == R_SUCCESS::R_STATUS_OK);
+    float difference = std::abs(arm - 22.0f);
+    REQUIRE(temp == Approx(difference <= 4.0f ? difference : difference * difference));
+
+    substrate_template_free(handle);
+}
+
+TEST_CASE("invalid template inputs", "[substrate_template]") {
+    substrate_template* handle = nullptr;
+    REQUIRE(substrate_template_create("", handle) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(handle == nullptr);
+
+    REQUIRE(substrate_template_create("0123", handle) == R_SUCCESS::R_STATUS_OK);
+
+    float temp = -1.0f;
+    REQUIRE(substrate_template_anneal(handle, "GCAUCG", 1.0f, 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+    REQUIRE(substrate_template_anneal(handle, "GCAT", 1.0f, 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(substrate_template_anneal(handle, "GCAU", 0.0f, 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
+    REQUIRE(substrate_template_accessibility(handle, "GCAU", "...", 1.0f, 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+    REQUIRE(substrate_template_anneal(nullptr, "GCAU", 1.0f, 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(temp == -1.0f);
+
+    substrate_template_free(handle);
+}
@@ -0,0 +1,114 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <string>
+
+#include "functions.h"
+
+using namespace ribosoft;
+using Catch::Approx;
+
+TEST_CASE("melting temperature on target", "[target_context]") {
+    const std::string rna = "GGAUGAUCGAUGCUGUAGCUGACUGCGCAA";
+    target_context* context = nullptr;
+    REQUIRE(target_context_create(rna.c_str(), context) == R_SUCCESS::R_STATUS_OK);
+
+    for (size_t start = 0; start + 4 <= rna.length(); start += 3) {
+        for (size_t length = 2; start + length <= rna.length(); length += 5) {
+            float expected, temp;
+            REQUIRE(melting_temperature(rna.substr(start, length).c_str(), 1.0f, 0.05f, expected) == R_SUCCESS::R_STATUS_OK);
+            REQUIRE(target_context_melting(context, start, length, 1.0f, 0.05f, temp) == R_SUCCESS::R_STATUS_OK);
+            REQUIRE(temp == Approx(expected));
+        }
+    }
+
+    target_context_free(context);
+}
+
+TEST_CASE("anneal on target", "[target_context]") {
+    const std::string rna = "CCAUGAUCGAUGCUGUAGCUGACUAAUUUCCCCGGGGGCC";
+    target_context* context = nullptr;
+    REQUIRE(target_context_create(rna.c_str(), context) == R_SUCCESS::R_STATUS_OK);
+
+    float expected, temp;
+    REQUIRE(anneal("AUGAUCGAUGCUGUAGCUGACU", "0000000000000000000000", 1.0f, 0.05f, 22.0f, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(target_context_anneal(context, 2, "0000000000000000000000", 1.0f, 0.05f, 22.0f, temp) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temp == Approx(expected));
+
+    REQUIRE(anneal("AAUUUCCCCGGGGG", "cba98..7..3210", 1.0f, 0.05f, 22.0f, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(target_context_anneal(context, 24, "cba98..7..3210", 1.0f, 0.05f, 22.0f, temp) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temp == Approx(expected));
+
+    target_context_free(context);
+}
+
+TEST_CASE("candidate score on target", "[target_context]") {
+    // the substrate at two cutsites, paired at the second one only
+    const std::string rna = "GGCAACUGCAUGUGAUGAACAACUGCAUGUGAUGCC";
+    const std::string structure = "........................((..))......";
+    const int cutsites[] = { 2, 19 };
+
+    target_context* target = nullptr;
+    pairing_index* index = nullptr;
+    REQUIRE(target_context_create(rna.c_str(), target) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(pairing_index_create(structure.c_str(), index) == R_SUCCESS::R_STATUS_OK);
+
+    float expected_temperature, temperature;
+    float expected[2], scores[2];
+    REQUIRE(candidate_score_indexed(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", index, cutsites, 2, 1.0f, 0.5f, 22.0f, expected_temperature, expected) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(target_context_candidate_score(nullptr, target, "cba987654..3210", index, cutsites, 2, 1.0f, 0.5f, 22.0f, temperature, scores) == R_SUCCESS::R_STATUS_OK);
+
+    REQUIRE(temperature == Approx(expected_temperature));
+    REQUIRE(scores[0] == 0.0f);
+    REQUIRE(scores[1] == Approx(expected[1]));
+
+    // the arm temperatures are now kept in the target context
+    uint64_t hits, misses;
+    size_t entries;
+    melting_cache_stats(hits, misses, entries);
+    REQUIRE(target_context_candidate_score(nullptr, target, "cba987654..3210", index, cutsites, 2, 1.0f, 0.5f, 22.0f, temperature, scores) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temperature == Approx(expected_temperature));
+
+    uint64_t next_hits, next_misses;
+    melting_cache_stats(next_hits, next_misses, entries);
+    REQUIRE(next_hits == hits);
+    REQUIRE(next_misses == misses);
+
+    // other concentrations are computed again
+    REQUIRE(target_context_candidate_score(nullptr, target, "cba987654..3210", index, cutsites, 2, 0.5f, 0.5f, 22.0f, temperature, scores) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(anneal("CAACUGCAUGUGAUG", "cba987654..3210", 0.5f, 0.5f, 22.0f, expected_temperature) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temperature == Approx(expected_temperature));
+
+    const int outside[] = { 22 };
+    pairing_index* shorter = nullptr;
+    REQUIRE(pairing_index_create("....", shorter) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(target_context_candidate_score(nullptr, target, "cba987654..3210", index, outside, 1, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(target_context_candidate_score(nullptr, target, "cba987654..3210", index, cutsites, 0, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(target_context_candidate_score(nullptr, target, "cba987654..3210", shorter, cutsites, 2, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER);
+    REQUIRE(target_context_candidate_score(nullptr, target, "", index, cutsites, 2, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(target_context_candidate_score(nullptr, nullptr, "cba987654..3210", index, cutsites, 2, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(target_context_candidate_score(nullptr, target, "cba987654..3210", index, cutsites, 2, 0.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
+
+    pairing_index_free(shorter);
+    pairing_index_free(index);
+    target_context_free(target);
+}
+
+TEST_CASE("invalid target context parameters", "[target_context]") {
+    target_context* context = nullptr;
+    REQUIRE(target_context_create("AUGX", context) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(target_context_create("", context) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+
+    REQUIRE(target_context_create("AUGCAUGC", context) == R_SUCCESS::R_STATUS_OK);
+
+    float temp;
+    REQUIRE(target_context_melting(nullptr, 0, 2, 1.0f, 0.05f, temp) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(target_context_melting(context, 6, 3, 1.0f, 0.05f, temp) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(target_context_melting(context, 2, 1, 1.0f, 0.05f, temp) == R_APPLICATION_ERROR::R_INVALID_ARM_LENGTH);
+    REQUIRE(target_context_melting(context, 0, 4, 0.0f, 0.05f, temp) == R_APPLICATION_ERROR::R_INVALID_CONCENTRATION);
+    REQUIRE(target_context_anneal(context, 4, "00000", 1.0f, 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(target_context_anneal(context, 0, "", 1.0f, 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(target_context_anneal(context, 0, nullptr, 1.0f, 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(target_context_anneal(nullptr, 0, "00", 1.0f, 0.05f, 22.0f, temp) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    target_context_free(context);
+}
@@ -0,0 +1,123 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+#include "functions.h"
+
+using namespace ribosoft;
+using Catch::Approx;
+
+static const char* PROFILE_SEQUENCE = "GGGAAAUCCCAUGUCUUAGGUGAUACGUGCAAGCUUCGGCUUGCAUCG";
+
+namespace {
+
+struct unpaired_rows {
+    std::vector<std::vector<float>> probabilities;
+
+    static int receive(size_t position, const float* probabilities, size_t count, void* data)
+    {
+        (void)position;
+        static_cast<unpaired_rows*>(data)->probabilities.emplace_back(probabilities, probabilities + count);
+        return 1;
+    }
+};
+
+}
+
+TEST_CASE("unpaired profile lookups", "[unpaired_profile]") {
+    const size_t length = strlen(PROFILE_SEQUENCE);
+    const int stretches[] = { 4, 9, 4 };
+
+    unpaired_profile* profile = nullptr;
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, stretches, 3, 30, 20, profile) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(profile != nullptr);
+
+    // same probabilities as streamed, keyed by start instead of end
+    unpaired_rows rows;
+    REQUIRE(local_unpaired_stream(nullptr, PROFILE_SEQUENCE, 30, 20, 9, &unpaired_rows::receive, &rows) == R_SUCCESS::R_STATUS_OK);
+
+    float probability;
+    for (size_t start = 0; start + 9 <= length; ++start) {
+        REQUIRE(unpaired_profile_probability(profile, start, 4, probability) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(probability == Approx(rows.probabilities[start + 3][3]));
+
+        REQUIRE(unpaired_profile_probability(profile, start, 9, probability) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(probability == Approx(rows.probabilities[start + 8][8]));
+    }
+
+    REQUIRE(unpaired_profile_probability(profile, length - 4, 4, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(unpaired_profile_probability(profile, length - 3, 4, probability) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(unpaired_profile_probability(profile, 0, 5, probability) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(unpaired_profile_probability(profile, 0, 10, probability) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(unpaired_profile_probability(nullptr, 0, 4, probability) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    unpaired_profile_free(profile);
+}
+
+TEST_CASE("unpaired profile of the whole RNA", "[unpaired_profile]") {
+    const int stretches[] = { 6 };
+
+    unpaired_profile* profile = nullptr;
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, stretches, 1, 0, 0, profile) == R_SUCCESS::R_STATUS_OK);
+
+    float probability;
+    REQUIRE(unpaired_profile_probability(profile, 10, 6, probability) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(probability >= 0.0f);
+    REQUIRE(probability <= 1.0f);
+
+    unpaired_profile_free(profile);
+}
+
+TEST_CASE("invalid unpaired profiles", "[unpaired_profile]") {
+    const int stretches[] = { 4, 0 };
+    const int too_long[] = { 31 };
+    const int huge[] = { 4, std::numeric_limits<int>::max() };
+    const int negative[] = { -4 };
+
+    unpaired_profile* profile = nullptr;
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, stretches, 0, 30, 20, profile) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, stretches, 2, 30, 20, profile) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, too_long, 1, 30, 20, profile) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, huge, 2, 30, 20, profile) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, huge, 2, 0, 0, profile) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, negative, 1, 30, 20, profile) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, "GGGAAAUCCC", too_long, 1, 0, 0, profile) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, nullptr, 1, 30, 20, profile) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, "", stretches, 1, 0, 0, profile) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, "", stretches, 1, 30, 20, profile) == R_APPLICATION_ERROR::R_EMPTY_PARAMETER);
+    REQUIRE(unpaired_profile_create(nullptr, "GGGAXAAUCCC", stretches, 1, 30, 20, profile) == R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE);
+    REQUIRE(profile == nullptr);
+}
+
+TEST_CASE("candidate score on profiled RNA", "[unpaired_profile]") {
+    // arms of the substrate structure "cba987654..3210"
+    const int stretches[] = { 9, 4 };
+    const int cutsites[] = { 0, 15, 3, 17 };
+
+    unpaired_profile* profile = nullptr;
+    REQUIRE(unpaired_profile_create(nullptr, PROFILE_SEQUENCE, stretches, 2, 30, 20, profile) == R_SUCCESS::R_STATUS_OK);
+
+    float expected_temperature, temperature;
+    float scores[4];
+    REQUIRE(anneal("CAACUGCAUGUGAUG", "cba987654..3210", 1.0f, 0.5f, 22.0f, expected_temperature) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(candidate_score_profiled(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", profile, cutsites, 4, 1.0f, 0.5f, 22.0f, temperature, scores) == R_SUCCESS::R_STATUS_OK);
+    REQUIRE(temperature == Approx(expected_temperature));
+
+    for (int i = 0; i < 4; ++i) {
+        float first, second;
+        REQUIRE(unpaired_profile_probability(profile, cutsites[i], 9, first) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(unpaired_profile_probability(profile, cutsites[i] + 11, 4, second) == R_SUCCESS::R_STATUS_OK);
+        REQUIRE(scores[i] == Approx((1.0f - first * second) * temperature));
+    }
+
+    // arm of length 8 is not profiled
+    REQUIRE(candidate_score_profiled(nullptr, "CAACUGCAUGUGAUG", "cba98765...3210", profile, cutsites, 4, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+
+    const int outside[] = { 40 };
+    REQUIRE(candidate_score_profiled(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", profile, outside, 1, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_OUT_OF_RANGE);
+    REQUIRE(candidate_score_profiled(nullptr, "CAACUGCAUGUGAUG", "cba987654..3210", nullptr, cutsites, 4, 1.0f, 0.5f, 22.0f, temperature, scores) == R_APPLICATION_ERROR::R_INVALID_PARAMETER);
+
+    unpaired_profile_free(profile);
+}
@@ -24,11 +24,20 @@ mkdir -p "$OUTPUT_DIR"
 # Source files
 SOURCES=(
     "$SCRIPT_DIR/src/anneal.cpp"
+    "$SCRIPT_DIR/src/target_context.cpp"
+    "$SCRIPT_DIR/src/substrate_template.cpp"
     "$SCRIPT_DIR/src/validation.cpp" 
     "$SCRIPT_DIR/src/fold.cpp"
+    "$SCRIPT_DIR/src/fold_pool.cpp"
+    "$SCRIPT_DIR/src/model_context.cpp"
     "$SCRIPT_DIR/src/structure.cpp"
+    "$SCRIPT_DIR/src/tree_distance.cpp"
     "$SCRIPT_DIR/src/accessibility.cpp"
+    "$SCRIPT_DIR/src/pairing_index.cpp"
     "$SCRIPT_DIR/src/mfe_default_fold.cpp"
+    "$SCRIPT_DIR/src/local_fold.cpp"
+    "$SCRIPT_DIR/src/unpaired_profile.cpp"
+    "$SCRIPT_DIR/src/packed_sequence.cpp"
 )
 
 # Include paths
@@ -3,9 +3,16 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
-#include <regex>
 
 #include "functions.h"
+#include "anneal.h"
+#include "model_context.h"
+#include "substrate_template.h"
+#include "pairing_index.h"
+#include "target_context.h"
+#include "unpaired_profile.h"
+#include "validation.h"
+#include "packed_sequence.h"
 
 //! \namespace ribosoft
 namespace ribosoft {
@@ -18,6 +25,8 @@ namespace ribosoft {
  * or the annealing temperature of the binding arms.
  *
  * Understanding return values:
+ * - R_INVALID_PARAMETER | a string is null
+ * - R_EMPTY_PARAMETER | substrate sequence is empty
  * - R_INVALID_NUCLEOTIDE | rna has an invalid nucleotide
  * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
  * - R_VIENNA_RNA_ERROR | An error has occured with ViennaRNA. Contact us with details.
@@ -32,64 +41,627 @@ namespace ribosoft {
  * \return Status Code
  */
 DLL_PUBLIC R_STATUS accessibility(const char* substrate_sequence, const char* substrate_structure, const char* folded_structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& score)
+{
+    if (substrate_sequence == nullptr || substrate_structure == nullptr || folded_structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    // the view validates and packs the sequence in one pass
+    return accessibility_view(substrate_sequence, strlen(substrate_sequence), substrate_structure, strlen(substrate_structure), folded_structure, strlen(folded_structure), na_concentration, probe_concentration, target_temp, score);
+}
+
+/*!
+ * \brief Accessibility score of views
+ * Same as `accessibility`, on strings given by their length, which need not be
+ * terminated: the folded structure can be the range of the folded RNA at the
+ * cutsite, passed in place.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | a string is null
+ * - R_EMPTY_PARAMETER | substrate sequence is empty
+ * - R_INVALID_NUCLEOTIDE | substrate sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence, structure and folded structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************
+ * \param substrate_sequence Start of the substrate sequence from candidate
+ * \param sequence_length Length of the substrate sequence
+ * \param substrate_structure Start of the substrate structure from the candidate
+ * \param structure_length Length of the substrate structure
+ * \param folded_structure Start of the structure of target sequence on rna (folded using ViennaRNA)
+ * \param folded_length Length of the folded structure
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param score Out variable for accessibility score
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS accessibility_view(const char* substrate_sequence, const size_t sequence_length, const char* substrate_structure, const size_t structure_length, const char* folded_structure, const size_t folded_length, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& score)
 {
     R_STATUS status;
 
-    // validate input sequence
-    status = validate_sequence(substrate_sequence);
+    // validate and pack input sequence
+    thread_local packed_sequence packed;
+    status = pack_sequence(substrate_sequence, sequence_length, packed);
     if (status != R_SUCCESS::R_STATUS_OK) {
         return status;
     }
 
-    std::string local_sequence = substrate_sequence;
-    std::string local_structure = substrate_structure;
-    std::string local_folded = folded_structure;
+    if (substrate_structure == nullptr || folded_structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
 
-    if (local_sequence.length() != local_structure.length() ||
-        local_structure.length() != local_folded.length()) {
+    if (sequence_length != structure_length || folded_length != structure_length) {
         return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
     }
 
-    // TODO: minimum chosen arbitrarily; will change once we have more science info
-    if (na_concentration < 0.0000000001f) {
-        return R_APPLICATION_ERROR::R_INVALID_CONCENTRATION;
+    status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
     }
 
-    if (probe_concentration < 0.0000000001f) {
-        return R_APPLICATION_ERROR::R_INVALID_CONCENTRATION;
+    // compiled per call on a per-thread template, so no allocation once warm
+    thread_local substrate_template compiled;
+    compile_substrate_template(substrate_structure, structure_length, compiled);
+
+    if (template_single_stranded(compiled, folded_structure))
+    {
+        score = 0.0f;
+    }
+    else
+    {
+        score = static_cast<float>(template_anneal(compiled, packed, na_concentration, probe_concentration, target_temp));
     }
 
-    std::regex base_regex("[0-9a-zA-Z]+");
+    return R_SUCCESS::R_STATUS_OK;
+}
 
-    bool isSingleStranded = true;
+/*! \struct anneal_conditions
+ * \brief Concentrations and target temperature a candidate is annealed at
+ */
+struct anneal_conditions {
+    float na_concentration; //!< Sodium (Na+) concentration (in moles)
+    float probe_concentration; //!< Nucleic acid concentration in excess (in moles)
+    float target_temp; //!< Target temperature of binding arms
+};
 
-    for (std::sregex_iterator i = std::sregex_iterator(local_structure.begin(), local_structure.end(), base_regex);
-        i != std::sregex_iterator();
-        ++i)
-    {
-        std::smatch match = *i;
-        for (int j = 0; j < match.length(); j++)
-        {
-            if (local_folded[match.position() + j] != '.')
-            {
-                isSingleStranded = false;
-                break;
-            }
+/*!
+ * \brief Annealing conditions of a candidate score
+ *
+ * \param context Model context of the job, or nullptr to use the arguments
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \return Conditions of the context if given, else the arguments
+ */
+static anneal_conditions candidate_conditions(const model_context* context, const float na_concentration, const float probe_concentration, const float target_temp)
+{
+    if (context != nullptr) {
+        return { context->na_concentration, context->probe_concentration, context->temperature };
+    }
+
+    return { na_concentration, probe_concentration, target_temp };
+}
+
+/*!
+ * \brief Validate and pack a candidate and compile its substrate structure
+ *
+ * \param substrate_sequence Start of the substrate sequence from candidate
+ * \param sequence_length Length of the substrate sequence
+ * \param substrate_structure Start of the substrate structure from the candidate
+ * \param structure_length Length of the substrate structure
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param packed Out variable for the packed substrate sequence
+ * \param compiled Out variable for the compiled substrate template
+ * \return Status Code
+ */
+static R_STATUS prepare_candidate(const char* substrate_sequence, const size_t sequence_length, const char* substrate_structure, const size_t structure_length, const float na_concentration, const float probe_concentration, /*out*/ packed_sequence& packed, /*out*/ substrate_template& compiled)
+{
+    R_STATUS status;
+
+    // validate and pack input sequence
+    status = pack_sequence(substrate_sequence, sequence_length, packed);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (substrate_structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (sequence_length != structure_length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    compile_substrate_template(substrate_structure, structure_length, compiled);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Check that every cutsite places the substrate within the RNA
+ *
+ * \param cutsite_indices Cutsite indices on the RNA
+ * \param cutsite_count Number of cutsite indices
+ * \param length Length of the substrate
+ * \param rna_length Length of the RNA
+ * \return Status Code
+ */
+static R_STATUS check_cutsites(const int* cutsite_indices, const size_t cutsite_count, const size_t length, const size_t rna_length)
+{
+    for (size_t i = 0; i < cutsite_count; ++i) {
+        if (cutsite_indices[i] < 0 || static_cast<size_t>(cutsite_indices[i]) > rna_length || length > rna_length - cutsite_indices[i]) {
+            return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
         }
+    }
 
-        if (!isSingleStranded)
-            break;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Candidate score across all its cutsites
+ * Used to calculate, in one call, the annealing temperature score of a
+ * candidate and its accessibility at each of its cutsites on the RNA.
+ * The binding arms are found once and their melting temperatures are computed
+ * at most once: the accessibility at a cutsite is perfect (0) if no binding arm
+ * is paired on the folded RNA there, or the annealing temperature score.
+ *
+ * Understanding return values:
+ * - R_INVALID_NUCLEOTIDE | substrate sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ * - R_OUT_OF_RANGE | a cutsite index places the substrate outside of the folded RNA
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, whose concentrations and temperature
+ * replace the next three arguments, or nullptr to use them
+ * \param substrate_sequence Substrate sequence from candidate
+ * \param substrate_structure Substrate structure from the candidate
+ * \param rna_structure Structure of the whole RNA (folded using ViennaRNA)
+ * \param cutsite_indices Cutsite indices on the RNA (beginning of the substrate sequence)
+ * \param cutsite_count Number of cutsite indices
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temperature_score Out variable for annealing temperature score
+ * \param accessibility_scores Out array of accessibility scores, one per cutsite index
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS candidate_score(const model_context* context, const char* substrate_sequence, const char* substrate_structure, const char* rna_structure, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores)
+{
+    return candidate_score_view(context, substrate_sequence, strlen(substrate_sequence), substrate_structure, strlen(substrate_structure), rna_structure, strlen(rna_structure), cutsite_indices, cutsite_count, na_concentration, probe_concentration, target_temp, temperature_score, accessibility_scores);
+}
+
+/*!
+ * \brief Candidate score of views
+ * Same as `candidate_score`, with the substrate sequence and structure given by their
+ * length, so they need not be terminated (for example ranges of the RNA input).
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | a string is null
+ * - R_EMPTY_PARAMETER | substrate sequence is empty
+ * - R_INVALID_NUCLEOTIDE | substrate sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ * - R_OUT_OF_RANGE | a cutsite index places the substrate outside of the folded RNA
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, whose concentrations and temperature
+ * replace the next three arguments, or nullptr to use them
+ * \param substrate_sequence Start of the substrate sequence from candidate
+ * \param sequence_length Length of the substrate sequence
+ * \param substrate_structure Start of the substrate structure from the candidate
+ * \param structure_length Length of the substrate structure
+ * \param rna_structure Start of the structure of the whole RNA (folded using ViennaRNA)
+ * \param rna_length Length of the structure of the whole RNA
+ * \param cutsite_indices Cutsite indices on the RNA (beginning of the substrate sequence)
+ * \param cutsite_count Number of cutsite indices
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temperature_score Out variable for annealing temperature score
+ * \param accessibility_scores Out array of accessibility scores, one per cutsite index
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS candidate_score_view(const model_context* context, const char* substrate_sequence, const size_t sequence_length, const char* substrate_structure, const size_t structure_length, const char* rna_structure, const size_t rna_length, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores)
+{
+    const anneal_conditions conditions = candidate_conditions(context, na_concentration, probe_concentration, target_temp);
+
+    if (rna_structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
     }
 
-    if (isSingleStranded)
-    {
+    thread_local packed_sequence packed;
+    thread_local substrate_template compiled;
+    R_STATUS status = prepare_candidate(substrate_sequence, sequence_length, substrate_structure, structure_length, conditions.na_concentration, conditions.probe_concentration, packed, compiled);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    status = check_cutsites(cutsite_indices, cutsite_count, compiled.length, rna_length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    const float score = static_cast<float>(template_anneal(compiled, packed, conditions.na_concentration, conditions.probe_concentration, conditions.target_temp));
+
+    for (size_t i = 0; i < cutsite_count; ++i) {
+        accessibility_scores[i] = template_single_stranded(compiled, rna_structure + cutsite_indices[i]) ? 0.0f : score;
+    }
+
+    temperature_score = score;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Candidate score across all its cutsites on an indexed RNA
+ * Same scores as `candidate_score`, with the folded RNA given as a pairing
+ * index so that each binding arm is checked in constant time at every cutsite.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | index is null
+ * - R_INVALID_NUCLEOTIDE | substrate sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ * - R_OUT_OF_RANGE | a cutsite index places the substrate outside of the folded RNA
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, whose concentrations and temperature
+ * replace the next three arguments, or nullptr to use them
+ * \param substrate_sequence Substrate sequence from candidate
+ * \param substrate_structure Substrate structure from the candidate
+ * \param index Pairing index of the whole RNA (see `pairing_index_create`)
+ * \param cutsite_indices Cutsite indices on the RNA (beginning of the substrate sequence)
+ * \param cutsite_count Number of cutsite indices
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temperature_score Out variable for annealing temperature score
+ * \param accessibility_scores Out array of accessibility scores, one per cutsite index
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS candidate_score_indexed(const model_context* context, const char* substrate_sequence, const char* substrate_structure, const pairing_index* index, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores)
+{
+    return candidate_score_indexed_view(context, substrate_sequence, strlen(substrate_sequence), substrate_structure, strlen(substrate_structure), index, cutsite_indices, cutsite_count, na_concentration, probe_concentration, target_temp, temperature_score, accessibility_scores);
+}
+
+/*!
+ * \brief Candidate score indexed of views
+ * Same as `candidate_score_indexed`, with the substrate sequence and structure given by their
+ * length, so they need not be terminated (for example ranges of the RNA input).
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | a string or the index is null
+ * - R_EMPTY_PARAMETER | substrate sequence is empty
+ * - R_INVALID_NUCLEOTIDE | substrate sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ * - R_OUT_OF_RANGE | a cutsite index places the substrate outside of the folded RNA
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, whose concentrations and temperature
+ * replace the next three arguments, or nullptr to use them
+ * \param substrate_sequence Start of the substrate sequence from candidate
+ * \param sequence_length Length of the substrate sequence
+ * \param substrate_structure Start of the substrate structure from the candidate
+ * \param structure_length Length of the substrate structure
+ * \param index Pairing index of the whole RNA (see `pairing_index_create`)
+ * \param cutsite_indices Cutsite indices on the RNA (beginning of the substrate sequence)
+ * \param cutsite_count Number of cutsite indices
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temperature_score Out variable for annealing temperature score
+ * \param accessibility_scores Out array of accessibility scores, one per cutsite index
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS candidate_score_indexed_view(const model_context* context, const char* substrate_sequence, const size_t sequence_length, const char* substrate_structure, const size_t structure_length, const pairing_index* index, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores)
+{
+    const anneal_conditions conditions = candidate_conditions(context, na_concentration, probe_concentration, target_temp);
+
+    if (index == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    thread_local packed_sequence packed;
+    thread_local substrate_template compiled;
+    R_STATUS status = prepare_candidate(substrate_sequence, sequence_length, substrate_structure, structure_length, conditions.na_concentration, conditions.probe_concentration, packed, compiled);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    status = check_cutsites(cutsite_indices, cutsite_count, compiled.length, index->length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    const float score = static_cast<float>(template_anneal(compiled, packed, conditions.na_concentration, conditions.probe_concentration, conditions.target_temp));
+
+    for (size_t i = 0; i < cutsite_count; ++i) {
+        accessibility_scores[i] = template_single_stranded(compiled, *index, cutsite_indices[i]) ? 0.0f : score;
+    }
+
+    temperature_score = score;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Candidate score across all its cutsites on a target context
+ * Same scores as `candidate_score_indexed`, with the substrate read in place on
+ * the target at its first cutsite (every cutsite holds the same substrate), so
+ * it is neither copied nor validated again, and the melting temperature of each
+ * binding arm looked up in the target context once another candidate computed it.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | target, substrate_structure or index is null
+ * - R_EMPTY_PARAMETER | substrate_structure is empty
+ * - R_STRUCT_LENGTH_DIFFER | the index is not of the target's length
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ * - R_OUT_OF_RANGE | there is no cutsite index, or one places the substrate outside of the target
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, whose concentrations and temperature
+ * replace the next three arguments, or nullptr to use them
+ * \param target Target context of the RNA (see `target_context_create`)
+ * \param substrate_structure Substrate structure from the candidate
+ * \param index Pairing index of the folded target (see `pairing_index_create`)
+ * \param cutsite_indices Cutsite indices on the target (beginning of the substrate sequence)
+ * \param cutsite_count Number of cutsite indices
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temperature_score Out variable for annealing temperature score
+ * \param accessibility_scores Out array of accessibility scores, one per cutsite index
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS target_context_candidate_score(const model_context* context, const target_context* target, const char* substrate_structure, const pairing_index* index, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores)
+{
+    const anneal_conditions conditions = candidate_conditions(context, na_concentration, probe_concentration, target_temp);
+
+    if (target == nullptr || substrate_structure == nullptr || index == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    const size_t length = strlen(substrate_structure);
+    if (length == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+    if (index->length != target->sequence.length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    if (cutsite_count == 0) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    R_STATUS status = check_cutsites(cutsite_indices, cutsite_count, length, target->sequence.length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    status = validate_concentrations(conditions.na_concentration, conditions.probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    thread_local substrate_template compiled;
+    compile_substrate_template(substrate_structure, length, compiled);
+
+    const float score = static_cast<float>(target_anneal(*target, compiled, cutsite_indices[0], conditions.na_concentration, conditions.probe_concentration, conditions.target_temp));
+
+    for (size_t i = 0; i < cutsite_count; ++i) {
+        accessibility_scores[i] = template_single_stranded(compiled, *index, cutsite_indices[i]) ? 0.0f : score;
+    }
+
+    temperature_score = score;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Candidate score across all its cutsites on a profiled RNA
+ * Same temperature score as `candidate_score`, with the accessibility taken over
+ * the ensemble of the RNA instead of one folded structure: the annealing
+ * temperature score weighted by the probability that some binding arm is paired
+ * at the cutsite, found in constant time from the unpaired profile.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | profile is null
+ * - R_INVALID_NUCLEOTIDE | substrate sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ * - R_OUT_OF_RANGE | a cutsite index places the substrate outside of the RNA, or a binding arm length is not profiled
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, whose concentrations and temperature
+ * replace the next three arguments, or nullptr to use them
+ * \param substrate_sequence Substrate sequence from candidate
+ * \param substrate_structure Substrate structure from the candidate
+ * \param profile Unpaired profile of the whole RNA (see `unpaired_profile_create`)
+ * \param cutsite_indices Cutsite indices on the RNA (beginning of the substrate sequence)
+ * \param cutsite_count Number of cutsite indices
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temperature_score Out variable for annealing temperature score
+ * \param accessibility_scores Out array of accessibility scores, one per cutsite index
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS candidate_score_profiled(const model_context* context, const char* substrate_sequence, const char* substrate_structure, const unpaired_profile* profile, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores)
+{
+    return candidate_score_profiled_view(context, substrate_sequence, strlen(substrate_sequence), substrate_structure, strlen(substrate_structure), profile, cutsite_indices, cutsite_count, na_concentration, probe_concentration, target_temp, temperature_score, accessibility_scores);
+}
+
+/*!
+ * \brief Candidate score profiled of views
+ * Same as `candidate_score_profiled`, with the substrate sequence and structure given by their
+ * length, so they need not be terminated (for example ranges of the RNA input).
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | a string or the profile is null
+ * - R_EMPTY_PARAMETER | substrate sequence is empty
+ * - R_INVALID_NUCLEOTIDE | substrate sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ * - R_OUT_OF_RANGE | a cutsite index places the substrate outside of the RNA, or a binding arm length is not profiled
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, whose concentrations and temperature
+ * replace the next three arguments, or nullptr to use them
+ * \param substrate_sequence Start of the substrate sequence from candidate
+ * \param sequence_length Length of the substrate sequence
+ * \param substrate_structure Start of the substrate structure from the candidate
+ * \param structure_length Length of the substrate structure
+ * \param profile Unpaired profile of the whole RNA (see `unpaired_profile_create`)
+ * \param cutsite_indices Cutsite indices on the RNA (beginning of the substrate sequence)
+ * \param cutsite_count Number of cutsite indices
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temperature_score Out variable for annealing temperature score
+ * \param accessibility_scores Out array of accessibility scores, one per cutsite index
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS candidate_score_profiled_view(const model_context* context, const char* substrate_sequence, const size_t sequence_length, const char* substrate_structure, const size_t structure_length, const unpaired_profile* profile, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores)
+{
+    const anneal_conditions conditions = candidate_conditions(context, na_concentration, probe_concentration, target_temp);
+
+    if (profile == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    thread_local packed_sequence packed;
+    thread_local substrate_template compiled;
+    R_STATUS status = prepare_candidate(substrate_sequence, sequence_length, substrate_structure, structure_length, conditions.na_concentration, conditions.probe_concentration, packed, compiled);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (!template_profiled(compiled, *profile)) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    status = check_cutsites(cutsite_indices, cutsite_count, compiled.length, profile->length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    const double score = template_anneal(compiled, packed, conditions.na_concentration, conditions.probe_concentration, conditions.target_temp);
+
+    for (size_t i = 0; i < cutsite_count; ++i) {
+        accessibility_scores[i] = static_cast<float>((1.0 - template_unpaired(compiled, *profile, cutsite_indices[i])) * score);
+    }
+
+    temperature_score = static_cast<float>(score);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Accessibility score of a validated sequence
+ * Same as `accessibility`, against a substrate template, without checking the
+ * sequence again.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence, template or folded structure is null
+ * - R_STRUCT_LENGTH_DIFFER | sequence, structure and folded structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************************
+ * \param substrate_sequence Validated substrate sequence (see `validated_sequence_create`)
+ * \param substrate_structure Substrate template (see `substrate_template_create`)
+ * \param folded_structure Structure of target sequence on rna (folded using ViennaRNA)
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param score Out variable for accessibility score
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS accessibility_validated(const validated_sequence* substrate_sequence, const substrate_template* substrate_structure, const char* folded_structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& score)
+{
+    if (substrate_sequence == nullptr || substrate_structure == nullptr || folded_structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    const size_t length = substrate_structure->length;
+    if (substrate_sequence->packed.length != length || strlen(folded_structure) != length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    R_STATUS status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (template_single_stranded(*substrate_structure, folded_structure)) {
         score = 0.0f;
-        return R_SUCCESS::R_STATUS_OK;
+    } else {
+        score = static_cast<float>(template_anneal(*substrate_structure, substrate_sequence->packed, na_concentration, probe_concentration, target_temp));
     }
-    else
-    {
-        return anneal(substrate_sequence, substrate_structure, na_concentration, probe_concentration, target_temp, score);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Candidate score of a validated sequence across all its cutsites on an indexed RNA
+ * Same scores as `candidate_score_indexed`, against a substrate template,
+ * without checking the sequence or compiling the structure again.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence, template or index is null
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ * - R_OUT_OF_RANGE | a cutsite index places the substrate outside of the folded RNA
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, whose concentrations and temperature
+ * replace the next three arguments, or nullptr to use them
+ * \param substrate_sequence Validated substrate sequence (see `validated_sequence_create`)
+ * \param substrate_structure Substrate template (see `substrate_template_create`)
+ * \param index Pairing index of the whole RNA (see `pairing_index_create`)
+ * \param cutsite_indices Cutsite indices on the RNA (beginning of the substrate sequence)
+ * \param cutsite_count Number of cutsite indices
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temperature_score Out variable for annealing temperature score
+ * \param accessibility_scores Out array of accessibility scores, one per cutsite index
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS candidate_score_validated(const model_context* context, const validated_sequence* substrate_sequence, const substrate_template* substrate_structure, const pairing_index* index, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores)
+{
+    const anneal_conditions conditions = candidate_conditions(context, na_concentration, probe_concentration, target_temp);
+
+    if (substrate_sequence == nullptr || substrate_structure == nullptr || index == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
     }
+
+    if (substrate_sequence->packed.length != substrate_structure->length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    R_STATUS status = validate_concentrations(conditions.na_concentration, conditions.probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    status = check_cutsites(cutsite_indices, cutsite_count, substrate_structure->length, index->length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    const float score = static_cast<float>(template_anneal(*substrate_structure, substrate_sequence->packed, conditions.na_concentration, conditions.probe_concentration, conditions.target_temp));
+
+    for (size_t i = 0; i < cutsite_count; ++i) {
+        accessibility_scores[i] = template_single_stranded(*substrate_structure, *index, cutsite_indices[i]) ? 0.0f : score;
+    }
+
+    temperature_score = score;
+    return R_SUCCESS::R_STATUS_OK;
 }
 
-}
\ No newline at end of file
+}
@@ -1,13 +1,21 @@
 #include "dll.h"
 
 #include <cstring>
-#include <regex>
-#include <iterator>
 #include <cmath>
+#include <algorithm>
 #include <vector>
 #include <mutex>
+#include <atomic>
+#include <array>
+#include <string_view>
+#include <unordered_map>
 
 #include "functions.h"
+#include "anneal.h"
+#include "substrate_template.h"
+#include "model_context.h"
+#include "validation.h"
+#include "packed_sequence.h"
 
 #include <melting.h>
 
@@ -16,6 +24,244 @@ namespace ribosoft {
 
 std::mutex melting_mutex; //!< Mutex to lock access to MELTING library
 
+// TODO: minimum chosen arbitrarily; will change once we have more science info
+constexpr float MIN_CONCENTRATION = 0.0000000001f; //!< Smallest sodium or probe concentration (in moles)
+
+constexpr size_t MELTING_CACHE_SHARDS = 64; //!< Number of independently locked cache shards
+constexpr size_t MELTING_CACHE_DEFAULT_ENTRIES = 1 << 18; //!< Default bound on the number of cached temperatures
+
+/*! \struct melting_key
+ * \brief Key of a cached MELTING temperature
+ */
+struct melting_key {
+    std::string arm; //!< Arm sequence
+    float na_concentration; //!< Sodium (Na+) concentration (in moles)
+    float probe_concentration; //!< Nucleic acid concentration in excess (in moles)
+
+    bool operator==(const melting_key&) const = default;
+};
+
+/*! \struct melting_key_hash
+ * \brief Hash of a cached MELTING temperature key
+ */
+struct melting_key_hash {
+    size_t operator()(const melting_key& key) const
+    {
+        size_t seed = std::hash<std::string_view>{}(key.arm);
+        seed ^= std::hash<float>{}(key.na_concentration) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        seed ^= std::hash<float>{}(key.probe_concentration) + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+        return seed;
+    }
+};
+
+/*! \struct melting_cache_shard
+ * \brief One shard of the MELTING temperature cache
+ */
+struct melting_cache_shard {
+    std::mutex mutex; //!< Mutex to lock access to this shard
+    std::unordered_map<melting_key, double, melting_key_hash> temperatures; //!< Cached temperatures
+};
+
+std::array<melting_cache_shard, MELTING_CACHE_SHARDS> melting_cache; //!< Memoized MELTING temperatures
+std::atomic<size_t> melting_cache_shard_entries{MELTING_CACHE_DEFAULT_ENTRIES / MELTING_CACHE_SHARDS}; //!< Bound on the entries of each shard
+std::atomic<uint64_t> melting_cache_hits{0}; //!< Number of temperatures found in the cache
+std::atomic<uint64_t> melting_cache_misses{0}; //!< Number of temperatures computed by MELTING
+
+/*!
+ * \brief Memoized MELTING temperature
+ * Looks the arm up in its shard and only calls MELTING (serialized) on a miss.
+ * A shard that reaches its bound is cleared before the new entry is stored.
+ *
+ * \param arm Validated arm sequence (A,C,G,U), of length 2 or more
+ * \param length Length of the arm
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \return Melting temperature (in degrees centigrade)
+ */
+static double cached_melting(const char* arm, size_t length, const float na_concentration, const float probe_concentration)
+{
+    melting_key key{ std::string(arm, length), na_concentration, probe_concentration };
+    const size_t hash = melting_key_hash{}(key);
+    melting_cache_shard& shard = melting_cache[hash % MELTING_CACHE_SHARDS];
+    const size_t shard_entries = melting_cache_shard_entries.load();
+
+    if (shard_entries > 0) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto found = shard.temperatures.find(key);
+        if (found != shard.temperatures.end()) {
+            melting_cache_hits.fetch_add(1, std::memory_order_relaxed);
+            return found->second;
+        }
+    }
+
+    melting_cache_misses.fetch_add(1, std::memory_order_relaxed);
+
+    double temperature;
+    {
+        // a lock is needed as melting's melting is not threadsafe
+        std::lock_guard<std::mutex> lock(melting_mutex);
+        temperature = melting(key.arm.c_str(), na_concentration, probe_concentration);
+    }
+
+    if (shard_entries > 0) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.temperatures.size() >= shard_entries) {
+            shard.temperatures.clear();
+        }
+        shard.temperatures.emplace(std::move(key), temperature);
+    }
+
+    return temperature;
+}
+
+/*!
+ * \brief Melting temperature of a binding arm
+ * Memoized MELTING on the arm unpacked to characters.
+ *
+ * \param packed Packed sequence holding the arm
+ * \param start Start of the arm
+ * \param length Length of the arm (2 or more), in bounds
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \return Melting temperature (in degrees centigrade)
+ */
+double arm_temperature(const packed_sequence& packed, size_t start, size_t length, const float na_concentration, const float probe_concentration)
+{
+    thread_local std::string arm;
+    arm.resize(length);
+    unpack_sequence(packed, start, length, arm.data());
+    return cached_melting(arm.data(), length, na_concentration, probe_concentration);
+}
+
+/*!
+ * \brief Validate concentrations
+ * Shared by every export that takes a sodium and a probe concentration.
+ *
+ * Understanding return values:
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \return Status Code
+ */
+R_STATUS validate_concentrations(const float na_concentration, const float probe_concentration)
+{
+    if (!(na_concentration >= MIN_CONCENTRATION && probe_concentration >= MIN_CONCENTRATION)) {
+        return R_APPLICATION_ERROR::R_INVALID_CONCENTRATION;
+    }
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Binding arm score
+ * Linear score until 4 degrees centigrade of difference to the target
+ * temperature, exponential score after that.
+ *
+ * \param temperature Melting temperature of the arm
+ * \param target_temp Target temperature of binding arms
+ * \return Score of the arm
+ */
+double arm_score(double temperature, const float target_temp)
+{
+    double difference = fabs(temperature - target_temp);
+
+    if (difference <= 4)
+        return difference;
+    else
+        return pow(difference, 2);
+}
+
+/*!
+ * \brief Configure the MELTING temperature cache
+ * Used to bound the number of memoized MELTING temperatures. The cache is
+ * cleared; a bound of 0 disables it.
+ *
+ ***************************************************************************************
+ * \param max_entries Maximum number of cached temperatures
+ */
+void melting_cache_configure(const size_t max_entries)
+{
+    melting_cache_shard_entries.store(max_entries == 0 ? 0 : std::max<size_t>(1, max_entries / MELTING_CACHE_SHARDS));
+    melting_cache_clear();
+}
+
+/*!
+ * \brief Clear the MELTING temperature cache
+ * Used to drop every memoized temperature and reset the hit and miss counters.
+ */
+void melting_cache_clear()
+{
+    for (melting_cache_shard& shard : melting_cache) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.temperatures.clear();
+    }
+
+    melting_cache_hits.store(0);
+    melting_cache_misses.store(0);
+}
+
+/*!
+ * \brief MELTING temperature cache statistics
+ *
+ ***************************************************************************************
+ * \param hits Out variable for the number of temperatures found in the cache
+ * \param misses Out variable for the number of temperatures computed by MELTING
+ * \param entries Out variable for the number of cached temperatures
+ */
+void melting_cache_stats(/*out*/ uint64_t& hits, /*out*/ uint64_t& misses, /*out*/ size_t& entries)
+{
+    hits = melting_cache_hits.load();
+    misses = melting_cache_misses.load();
+
+    entries = 0;
+    for (melting_cache_shard& shard : melting_cache) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        entries += shard.temperatures.size();
+    }
+}
+
+/*!
+ * \brief Melting temperature
+ * Used to calculate the melting temperature of a sequence with its complement,
+ * as for one binding arm (memoized, see `melting_cache_configure`).
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null
+ * - R_EMPTY_PARAMETER | sequence is empty
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_INVALID_ARM_LENGTH | sequence length is 1
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************************
+ * \param sequence Sequence
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param temp Out variable for the melting temperature (in degrees centigrade)
+ * \return Status Code
+ */
+R_STATUS melting_temperature(const char* sequence, const float na_concentration, const float probe_concentration, /*out*/ float& temp)
+{
+    thread_local packed_sequence packed;
+    R_STATUS status = pack_sequence(sequence, packed);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    const size_t length = packed.length;
+    if (length == 1) {
+        return R_APPLICATION_ERROR::R_INVALID_ARM_LENGTH;
+    }
+
+    status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    temp = static_cast<float>(arm_temperature(packed, 0, length, na_concentration, probe_concentration));
+    return R_SUCCESS::R_STATUS_OK;
+}
+
 /*!
  * \brief Annealing Temperature Score
  * Used to calculate the annealing temperature of the ribozyme to the
@@ -24,6 +270,8 @@ std::mutex melting_mutex; //!< Mutex to lock access to MELTING library
  * Bioinformatics, 17: 1226-1227.
  *
  * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence or structure is null
+ * - R_EMPTY_PARAMETER | sequence is empty
  * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
  * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
  * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
@@ -39,67 +287,134 @@ std::mutex melting_mutex; //!< Mutex to lock access to MELTING library
  * \return Status Code
  */
 R_STATUS anneal(const char* sequence, const char* structure, const float na_concentration, const float probe_concentration, const float target_temp, float& temp)
+{
+    if (sequence == nullptr || structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    // the view validates and packs the sequence in one pass
+    return anneal_view(sequence, strlen(sequence), structure, strlen(structure), na_concentration, probe_concentration, target_temp, temp);
+}
+
+/*!
+ * \brief Annealing Temperature Score of views
+ * Same as `anneal`, on a sequence and a structure given by their length, which
+ * need not be terminated (for example ranges of longer strings). Nothing is copied.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence or structure is null
+ * - R_EMPTY_PARAMETER | sequence is empty
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************************
+ * \param sequence Start of the substrate sequence
+ * \param sequence_length Length of the substrate sequence
+ * \param structure Start of the substrate structure
+ * \param structure_length Length of the substrate structure
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temp Out variable for annealing temperature score
+ * \return Status Code
+ */
+R_STATUS anneal_view(const char* sequence, const size_t sequence_length, const char* structure, const size_t structure_length, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temp)
 {
     R_STATUS status;
 
-    // validate input sequence
-    status = validate_sequence(sequence);
+    // validate and pack input sequence
+    thread_local packed_sequence packed;
+    status = pack_sequence(sequence, sequence_length, packed);
     if (status != R_SUCCESS::R_STATUS_OK) {
         return status;
     }
-    
-    std::string local_sequence = sequence;
-    std::string local_structure = structure;
 
-    if (local_sequence.length() != local_structure.length()) {
-        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    if (structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
     }
 
-    // TODO: minimum chosen arbitrarily; will change once we have more science info
-    if (na_concentration < 0.0000000001f) {
-        return R_APPLICATION_ERROR::R_INVALID_CONCENTRATION;
+    if (sequence_length != structure_length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
     }
 
-    if (probe_concentration < 0.0000000001f) {
-        return R_APPLICATION_ERROR::R_INVALID_CONCENTRATION;
+    status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
     }
 
-    std::regex base_regex("[0-9a-zA-Z]+");
-    auto substruct_begin = std::sregex_iterator(local_structure.begin(), local_structure.end(), base_regex);
-    auto substruct_end = std::sregex_iterator();
+    // compiled per call on a per-thread template, so no allocation once warm
+    thread_local substrate_template compiled;
+    compile_substrate_template(structure, structure_length, compiled);
+
+    double temp_sum = template_anneal(compiled, packed, na_concentration, probe_concentration, target_temp);
 
-    std::vector<std::string> substrings;
+    temp = static_cast<float>(temp_sum);
+    return R_SUCCESS::R_STATUS_OK;
+}
 
-    for (std::sregex_iterator i = substruct_begin; i != substruct_end; ++i) {
-        std::smatch match = *i;
-        substrings.push_back(local_sequence.substr(match.position(), match.length()));
+/*!
+ * \brief Annealing Temperature Score in a model context
+ * Same as `anneal`, at the Na+ and probe concentrations and target temperature
+ * of the context.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | context is null
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ *
+ ***************************************************************************************
+ * \param context Model context of the job
+ * \param sequence Substrate sequence
+ * \param structure Substrate structure to determine binding regions
+ * \param temp Out variable for annealing temperature score
+ * \return Status Code
+ */
+R_STATUS anneal_with_context(const model_context* context, const char* sequence, const char* structure, /*out*/ float& temp)
+{
+    if (context == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
     }
 
-    double temp_sum = 0.0;
-    double difference = 0.0;
+    return anneal(sequence, structure, context->na_concentration, context->probe_concentration, context->temperature, temp);
+}
 
-    for (size_t i = 0; i < substrings.size(); i++) {
-        // A arm length of 1 will cause melting to crash
-        // Ignore that arm
-        if (substrings[i].length() != 1)
-        {
-            // Calculate melting temperature
-            // a lock is needed as melting's melting is not threadsafe
-            std::lock_guard<std::mutex> lock(melting_mutex);
-           
-            // Linear score until 4 degrees centigrade of difference
-            // Exponential score after that 
-            difference = fabs(melting(substrings[i].c_str(), na_concentration, probe_concentration) - target_temp);
+/*!
+ * \brief Annealing Temperature Score of a validated sequence
+ * Same as `anneal`, against a substrate template, without checking the
+ * sequence again.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence or template is null
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************************
+ * \param sequence Validated substrate sequence (see `validated_sequence_create`)
+ * \param structure Substrate template (see `substrate_template_create`)
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temp Out variable for annealing temperature score
+ * \return Status Code
+ */
+R_STATUS anneal_validated(const validated_sequence* sequence, const substrate_template* structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temp)
+{
+    if (sequence == nullptr || structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
 
-            if (difference <= 4)
-                temp_sum += difference;
-            else
-                temp_sum += pow(difference, 2);
-        }
+    if (sequence->packed.length != structure->length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
     }
 
-    temp = static_cast<float>(temp_sum);
+    R_STATUS status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    temp = static_cast<float>(template_anneal(*structure, sequence->packed, na_concentration, probe_concentration, target_temp));
     return R_SUCCESS::R_STATUS_OK;
 }
 
-}
\ No newline at end of file
+}
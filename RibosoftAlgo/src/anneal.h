@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstddef>
+
+#include "functions.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+struct packed_sequence;
+
+/*! \fn validate_concentrations
+ * \brief Check that the sodium and probe concentrations are within range (R_INVALID_CONCENTRATION otherwise)
+ * @file anneal.cpp
+ */
+R_STATUS validate_concentrations(const float na_concentration, const float probe_concentration);
+
+/*! \fn arm_temperature
+ * \brief Memoized MELTING temperature of a binding arm, a range of a packed sequence
+ * @file anneal.cpp
+ */
+double arm_temperature(const packed_sequence& packed, size_t start, size_t length, const float na_concentration, const float probe_concentration);
+
+/*! \fn arm_score
+ * \brief Annealing score of one binding arm from its melting temperature
+ * @file anneal.cpp
+ */
+double arm_score(double temperature, const float target_temp);
+
+}
@@ -1,13 +1,28 @@
 #include "dll.h"
 
 #include <cstdlib>
+#include <cstring>
 #include <cmath>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include <mutex>
+#include <unordered_map>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include <ViennaRNA/data_structures.h>
 #include <ViennaRNA/subopt.h>
 #include <ViennaRNA/part_func.h>
 
 #include "functions.h"
+#include "fold.h"
+#include "fold_pool.h"
+#include "model_context.h"
+#include "validation.h"
 
 extern "C" {
     /**
@@ -50,6 +65,37 @@ extern "C" {
      *  @return               A prefilled vrna_fold_compound_t that can be readily used for computations
      */
     vrna_fold_compound_t* vrna_fold_compound(const char* sequence, vrna_md_t* md_p, unsigned int options);
+
+    /**
+     *  @brief Apply default model details to a provided #vrna_md_t data structure
+     *
+     *  Use this function to initialize a #vrna_md_t data structure with
+     *  its default values
+     *
+     *  @param md A pointer to the data structure that is about to be initialized
+     */
+    void vrna_md_set_default(vrna_md_t* md);
+
+    /**
+     *  @brief Sample a secondary structure from the Boltzmann ensemble according its probability
+     *
+     *  @pre    The fold compound has to be obtained using the #VRNA_OPTION_HYBRID option in vrna_fold_compound()
+     *  @pre    vrna_pf() has to be called first to fill the partition function matrices
+     *  @note   The unique multiloop decomposition (uniq_ML) must be set in the model details
+     *
+     *  @param  vc      The fold compound data structure
+     *  @return         A sampled secondary structure in dot-bracket notation
+     */
+    char* vrna_pbacktrack(vrna_fold_compound_t* vc);
+
+    /**
+     *  @brief Calculate the free energy of an already folded RNA
+     *
+     *  @param  vc                fold compound
+     *  @param  structure         secondary structure in dot-bracket notation
+     *  @return                   the free energy of the input structure given the input sequence in kcal/mol
+     */
+    float vrna_eval_structure(vrna_fold_compound_t* vc, const char* structure);
 }
 
 //! \namespace ribosoft
@@ -57,57 +103,258 @@ namespace ribosoft {
 
 #define EPSILON 0.000001 //!< Epsilon to determine if equal to zero
 
+constexpr double GAS_CONSTANT = 1.98717; //!< Gas constant (cal/(K.mol)), as in ViennaRNA
+constexpr double KELVIN = 273.15; //!< 0 degrees centigrade in Kelvin
+
+constexpr size_t NON_REDUNDANT_DRAW_FACTOR = 8; //!< Draws per requested structure before non-redundant sampling gives up
+
+std::mutex sampling_mutex; //!< Mutex to lock access to ViennaRNA's random number generator
+
 /*!
- * \brief Fold
- * Used to fold the RNA sequence and provide the probabilities
- * of each fold in the distribution. Folding is done using ViennaRNA
+ * \brief Unpaired probabilities from the base pair probabilities
  *
- * Understanding return values:
- * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
- * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ * \param probs Base pair probabilities left by `vrna_pf`
+ * \param iindx ViennaRNA index of the pairs, (i, j) 1-based with i < j at iindx[i] - j
+ * \param length Length of the sequence
+ * \param unpaired Out variable for the probability of each position to be unpaired
+ */
+static void unpaired_probabilities(const FLT_OR_DBL* probs, const int* iindx, size_t length, /*out*/ std::vector<double>& unpaired)
+{
+    unpaired.assign(length, 1.0);
+
+    for (size_t i = 1; i <= length; ++i) {
+        for (size_t j = i + 1; j <= length; ++j) {
+            const double probability = probs[iindx[i] - static_cast<int>(j)];
+            unpaired[i - 1] -= probability;
+            unpaired[j - 1] -= probability;
+        }
+    }
+
+    for (double& probability : unpaired) {
+        probability = std::max(0.0, probability);
+    }
+}
+
+/*!
+ * \brief Ensemble data from the base pair probabilities
+ * Reads the base pair probability matrix left by `vrna_pf` once, O(n^2).
+ * The centroid structure holds every pair of probability above 0.5, which are
+ * always compatible with each other.
  *
- ***************************************************************************************
- * \param sequence Ribozyme sequence
- * \param output Out variable for fold structures
- * \param size Out variable for the size of the fold_output
+ * \param vc Fold compound after `vrna_pf`
+ * \param length Length of the sequence
+ * \param energy Ensemble free energy
+ * \param bpp_cutoff Minimum probability of the pairs to list
+ * \param ensemble Out variable for the ensemble data
  * \return Status Code
  */
-DLL_PUBLIC R_STATUS fold(const char* sequence, /*out*/ fold_output*& output, /*out*/ size_t& size)
+static R_STATUS collect_ensemble(vrna_fold_compound_t* vc, size_t length, float energy, float bpp_cutoff, /*out*/ fold_ensemble& ensemble)
 {
-    // validate input sequence
-    R_STATUS status = validate_sequence(sequence);
-    if (status != R_SUCCESS::R_STATUS_OK) {
-        return status;
+    if (vc->exp_matrices == NULL || vc->exp_matrices->probs == NULL || vc->iindx == NULL) {
+        return R_SYSTEM_ERROR::R_VIENNA_RNA_ERROR;
     }
 
-    size_t length = strlen(sequence);
+    const FLT_OR_DBL* probs = vc->exp_matrices->probs;
+    const int* iindx = vc->iindx;
+
+    std::vector<double> unpaired;
+    unpaired_probabilities(probs, iindx, length, unpaired);
+
+    std::vector<fold_pair> pairs;
+
+    ensemble.energy = energy;
+    ensemble.centroid = new char[length + 1];
+    memset(ensemble.centroid, '.', length);
+    ensemble.centroid[length] = '\0';
+
+    // ViennaRNA indexes pairs (i, j), 1-based with i < j, at iindx[i] - j
+    for (size_t i = 1; i <= length; ++i) {
+        for (size_t j = i + 1; j <= length; ++j) {
+            const double probability = probs[iindx[i] - static_cast<int>(j)];
+            if (probability <= 0.0) {
+                continue;
+            }
+
+            if (probability > 0.5) {
+                ensemble.centroid[i - 1] = '(';
+                ensemble.centroid[j - 1] = ')';
+            }
+
+            if (probability >= bpp_cutoff) {
+                pairs.push_back({ static_cast<int>(i - 1), static_cast<int>(j - 1), static_cast<float>(probability) });
+            }
+        }
+    }
+
+    ensemble.unpaired = new float[length];
+    for (size_t i = 0; i < length; ++i) {
+        ensemble.unpaired[i] = static_cast<float>(unpaired[i]);
+    }
+
+    ensemble.pair_count = pairs.size();
+    ensemble.pairs = new fold_pair[pairs.size()];
+    std::copy(pairs.begin(), pairs.end(), ensemble.pairs);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free suboptimal structures returned by `vrna_subopt`
+ *
+ * \param sol Suboptimal structures, terminated by a null structure
+ */
+static void free_solutions(vrna_subopt_solution_t* sol)
+{
+    for (size_t i = 0; sol[i].structure != nullptr; ++i) {
+        free(sol[i].structure);
+    }
+    free(sol);
+}
+
+/*!
+ * \brief Boltzmann factor unit of a model
+ * The same kT as ViennaRNA's Boltzmann factors, without computing them.
+ *
+ * \param md Model details, or nullptr for the defaults
+ * \return Boltzmann factor unit (kcal/mol)
+ */
+static double model_kT(const vrna_md_t* md)
+{
+    vrna_md_t defaults;
+    if (md == nullptr) {
+        vrna_md_set_default(&defaults);
+        md = &defaults;
+    }
+
+    return md->betaScale * (md->temperature + KELVIN) * GAS_CONSTANT / 1000.;
+}
 
-    // get a vrna_fold_compound with default settings
-    vrna_fold_compound_t *vc = vrna_fold_compound(sequence, NULL, VRNA_OPTION_DEFAULT);
+/*!
+ * \brief Suboptimal structures and partition function of a sequence
+ * Shared by every output layout of `fold`.
+ *
+ * \param sequence Validated ribozyme sequence
+ * \param length Length of the sequence
+ * \param sol Out variable for the suboptimal structures by increasing energy, freed with `free_solutions`
+ * \param count Out variable for the number of suboptimal structures
+ * \param energy Out variable for the ensemble free energy
+ * \param kT Out variable for the Boltzmann factor unit (kcal/mol)
+ * \param ensemble Out variable for the ensemble data, or nullptr to discard it
+ * \param bpp_cutoff Minimum probability of the pairs to list in the ensemble data
+ * \param context Model context, or nullptr for the default model
+ * \param normalization FOLD_NORMALIZATION of the probabilities; the partition function
+ * (and the ensemble data) is skipped with `FOLD_NORMALIZATION_SUBOPTIMAL`
+ * \return Status Code
+ */
+static R_STATUS fold_solutions(const char* sequence, size_t length, /*out*/ vrna_subopt_solution_t*& sol, /*out*/ size_t& count, /*out*/ double& energy, /*out*/ double& kT, /*out*/ fold_ensemble* ensemble, const float bpp_cutoff, const model_context* context, const int normalization)
+{
+    // get a vrna_fold_compound with the context's settings (default without context)
+    const vrna_md_t* md = context_model_details(context);
+    vrna_fold_compound_t *vc = acquire_fold_compound(sequence, md);
+    context_prepare_mfe(vc, context);
 
     // fold with suboptimal structures
     // TODO: consider passing energy range from user input
-    vrna_subopt_solution_t *sol = vrna_subopt(vc, 500, 1, NULL);
+    sol = vrna_subopt(vc, 500, 1, NULL);
+
+    count = 0;
+    while (sol[count].structure != nullptr) {
+        count++;
+    }
+
+    if (normalization == FOLD_NORMALIZATION::FOLD_NORMALIZATION_SUBOPTIMAL) {
+        release_fold_compound(vc, md);
+
+        // the ensemble energy of the band only
+        kT = model_kT(md);
+
+        double weight = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            weight += std::exp((sol[0].energy - sol[i].energy) / kT);
+        }
+        energy = count == 0 ? 0.0 : sol[0].energy - kT * std::log(weight);
+        return R_SUCCESS::R_STATUS_OK;
+    }
 
     // Get pf energy
+    context_prepare_pf(vc, context);
     char *pf_struc = (char*)malloc(length + 1);
-    float energy = vrna_pf(vc, pf_struc);
+    energy = vrna_pf(vc, pf_struc);
+    free(pf_struc);
 
-    if (vc->exp_params == NULL) {
+    if (vc->exp_params == NULL || std::abs(vc->exp_params->kT / 1000.) < EPSILON) {
+        free_solutions(sol);
+        release_fold_compound(vc, md);
         return R_SYSTEM_ERROR::R_VIENNA_RNA_ERROR;
     }
 
-    double kT = vc->exp_params->kT / 1000.;
-    if (std::abs(kT) < EPSILON) {
-        return R_SYSTEM_ERROR::R_VIENNA_RNA_ERROR;
+    kT = vc->exp_params->kT / 1000.;
+
+    if (ensemble != nullptr) {
+        *ensemble = {};
+        R_STATUS status = collect_ensemble(vc, length, static_cast<float>(energy), bpp_cutoff, *ensemble);
+        if (status != R_SUCCESS::R_STATUS_OK) {
+            free_solutions(sol);
+            release_fold_compound(vc, md);
+            return status;
+        }
     }
 
-    // initialize output
+    release_fold_compound(vc, md);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Copy suboptimal structures into column buffers
+ *
+ * \param sol Suboptimal structures by increasing energy
+ * \param count Number of structures to copy
+ * \param length Length of the sequence
+ * \param energy Ensemble free energy
+ * \param kT Boltzmann factor unit (kcal/mol)
+ * \param structures Out buffer of count * (length + 1) characters
+ * \param probabilities Out buffer of count probabilities
+ * \param energies Out buffer of count free energies, or nullptr to discard them
+ */
+static void write_columns(const vrna_subopt_solution_t* sol, size_t count, size_t length, double energy, double kT, /*out*/ char* structures, /*out*/ float* probabilities, /*out*/ float* energies)
+{
+    for (size_t i = 0; i < count; ++i) {
+        char* structure = structures + i * (length + 1);
+        strncpy(structure, sol[i].structure, length);
+        structure[length] = '\0';
+        probabilities[i] = std::exp((energy - sol[i].energy) / kT);
+
+        if (energies != nullptr) {
+            energies[i] = sol[i].energy;
+        }
+    }
+}
+
+/*!
+ * \brief Fold a validated sequence, optionally keeping the ensemble data
+ *
+ * \param sequence Validated ribozyme sequence
+ * \param length Length of the sequence
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \param ensemble Out variable for the ensemble data, or nullptr to discard it
+ * \param bpp_cutoff Minimum probability of the pairs to list in the ensemble data
+ * \param context Model context, or nullptr for the default model
+ * \param normalization FOLD_NORMALIZATION of the probabilities (without ensemble data if not by the partition function)
+ * \return Status Code
+ */
+R_STATUS fold_validated_sequence(const char* sequence, size_t length, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ fold_ensemble* ensemble, const float bpp_cutoff, const model_context* context, const int normalization)
+{
+    vrna_subopt_solution_t* sol = nullptr;
     size_t solution_size = 0;
-    while(sol[solution_size].structure != nullptr) {
-        solution_size++;
+    double energy, kT;
+    R_STATUS status = fold_solutions(sequence, length, sol, solution_size, energy, kT, ensemble, bpp_cutoff, context, normalization);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
     }
 
+    // initialize output
     size = solution_size;
     output = new fold_output[solution_size];
     for (size_t i = 0; i < solution_size; ++i) {
@@ -115,35 +362,917 @@ DLL_PUBLIC R_STATUS fold(const char* sequence, /*out*/ fold_output*& output, /*o
         strncpy(output[i].structure, sol[i].structure, length);
         output[i].structure[length] = '\0';
         output[i].probability = std::exp((energy - sol[i].energy) / kT);
-
-        free(sol[i].structure);
     }
 
     // free memory
-    free(sol);
-    vrna_fold_compound_free(vc);
-    free(pf_struc);
+    free_solutions(sol);
 
     return R_SUCCESS::R_STATUS_OK;
 }
 
 /*!
- * \brief Free memory from fold outputs
- * Used to free the memory from the fold structure
+ * \brief Fold, optionally keeping the ensemble data
  *
- ***************************************************************************************
- * @param output Fold structure to be freed
- * @param size Size of the output
+ * \param sequence Ribozyme sequence
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \param ensemble Out variable for the ensemble data, or nullptr to discard it
+ * \param bpp_cutoff Minimum probability of the pairs to list in the ensemble data
+ * \param context Model context, or nullptr for the default model
+ * \return Status Code
  */
-DLL_PUBLIC void fold_output_free(fold_output* output, size_t size)
+static R_STATUS fold_sequence(const char* sequence, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ fold_ensemble* ensemble, const float bpp_cutoff, const model_context* context)
 {
-    if (output) {
-        for (size_t i = 0; i < size; ++i) {
-            delete[] output[i].structure;
-            output[i].structure = nullptr;
+    // validate input sequence
+    size_t length;
+    R_STATUS status = validate_sequence_position(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    return fold_validated_sequence(sequence, length, output, size, ensemble, bpp_cutoff, context, FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION);
+}
+
+/*!
+ * \brief Ensemble defect
+ * Expected number of positions not in their ideal state over the Boltzmann
+ * ensemble: n - sum(u_i for ideally unpaired i) - sum(2 * p_ij for ideal pairs (i, j)).
+ * Only the partition function is computed, so the cost after folding is
+ * O(n^2) however many suboptimal structures the sequence has.
+ *
+ * Understanding return values:
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ * \param sequence Validated sequence
+ * \param length Length of the sequence
+ * \param pairs Ideal pair table: pairs[i] is the 0-based partner of i, or -1 if unpaired
+ * \param context Model context, or nullptr for the default model
+ * \param defect Out variable for the ensemble defect
+ * \return Status Code
+ */
+R_STATUS fold_ensemble_defect(const char* sequence, size_t length, const std::vector<int>& pairs, const model_context* context, /*out*/ double& defect)
+{
+    const vrna_md_t* md = context_model_details(context);
+    vrna_fold_compound_t *vc = acquire_fold_compound(sequence, md);
+    context_prepare_pf(vc, context);
+    (void)vrna_pf(vc, NULL); // ensemble energy not used, only the pair probabilities
+
+    if (vc->exp_matrices == NULL || vc->exp_matrices->probs == NULL || vc->iindx == NULL) {
+        release_fold_compound(vc, md);
+        return R_SYSTEM_ERROR::R_VIENNA_RNA_ERROR;
+    }
+
+    const FLT_OR_DBL* probs = vc->exp_matrices->probs;
+    const int* iindx = vc->iindx;
+
+    std::vector<double> unpaired;
+    unpaired_probabilities(probs, iindx, length, unpaired);
+
+    double correct = 0.0;
+    for (size_t i = 0; i < length; ++i) {
+        if (pairs[i] < 0) {
+            correct += unpaired[i];
+        } else if (static_cast<size_t>(pairs[i]) > i) {
+            correct += 2.0 * probs[iindx[i + 1] - (pairs[i] + 1)];
         }
+    }
 
-        delete[] output;
+    release_fold_compound(vc, md);
+
+    defect = static_cast<double>(length) - correct;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Fold
+ * Used to fold the RNA sequence and provide the probabilities
+ * of each fold in the distribution. Folding is done using ViennaRNA
+ *
+ * Understanding return values:
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param sequence Ribozyme sequence
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold(const char* sequence, /*out*/ fold_output*& output, /*out*/ size_t& size)
+{
+    return fold_sequence(sequence, output, size, nullptr, 0.0f, nullptr);
+}
+
+/*!
+ * \brief Fold in a model context
+ * Same as `fold`, with the model details of the context (temperature,
+ * dangles, maximum base pair span) and its precomputed Boltzmann factors.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | context is null
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job
+ * \param sequence Ribozyme sequence
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_with_context(const model_context* context, const char* sequence, /*out*/ fold_output*& output, /*out*/ size_t& size)
+{
+    if (context == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    return fold_sequence(sequence, output, size, nullptr, 0.0f, context);
+}
+
+/*!
+ * \brief Fold a validated sequence
+ * Same as `fold`, without checking the sequence again.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Validated ribozyme sequence (see `validated_sequence_create`)
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_validated(const model_context* context, const validated_sequence* sequence, /*out*/ fold_output*& output, /*out*/ size_t& size)
+{
+    if (sequence == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    return fold_validated_sequence(sequence->sequence.c_str(), sequence->sequence.size(), output, size, nullptr, 0.0f, context, FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION);
+}
+
+/*!
+ * \brief Fold of a view
+ * Same as `fold`, on a sequence given by its length, which need not be
+ * terminated (for example a range of the RNA input). ViennaRNA reads terminated
+ * strings, so the view is copied once into a buffer reused by the thread.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null
+ * - R_EMPTY_PARAMETER | length is 0
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Start of the ribozyme sequence
+ * \param length Length of the sequence
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_view(const model_context* context, const char* sequence, const size_t length, /*out*/ fold_output*& output, /*out*/ size_t& size)
+{
+    R_STATUS status = validate_sequence_view(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    thread_local std::string terminated;
+    terminated.assign(sequence, length);
+
+    return fold_validated_sequence(terminated.c_str(), length, output, size, nullptr, 0.0f, context, FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION);
+}
+
+/*!
+ * \brief Fold with ensemble data
+ * Same as `fold`, also keeping what the partition function computes: the
+ * ensemble free energy, the probability of each position to be unpaired, the
+ * centroid structure and the base pairs of probability at least `bpp_cutoff`.
+ * No additional folding is done.
+ *
+ * Understanding return values:
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | bpp_cutoff is not within [0, 1]
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Ribozyme sequence
+ * \param bpp_cutoff Minimum probability of the base pairs to list
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \param ensemble Out variable for the ensemble data, released with `fold_ensemble_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_with_ensemble(const model_context* context, const char* sequence, const float bpp_cutoff, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ fold_ensemble*& ensemble)
+{
+    ensemble = nullptr;
+
+    if (!(bpp_cutoff >= 0.0f && bpp_cutoff <= 1.0f)) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    fold_ensemble* result = new fold_ensemble{};
+    R_STATUS status = fold_sequence(sequence, output, size, result, bpp_cutoff, context);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        fold_ensemble_free(result);
+        return status;
+    }
+
+    ensemble = result;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Fold of a view with ensemble data
+ * Same as `fold_with_ensemble`, on a sequence given by its length, which need
+ * not be terminated. ViennaRNA reads terminated strings, so the view is copied
+ * once into a buffer reused by the thread.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null
+ * - R_EMPTY_PARAMETER | length is 0
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | bpp_cutoff is not within [0, 1]
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Start of the ribozyme sequence
+ * \param length Length of the sequence
+ * \param bpp_cutoff Minimum probability of the base pairs to list
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \param ensemble Out variable for the ensemble data, released with `fold_ensemble_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_with_ensemble_view(const model_context* context, const char* sequence, const size_t length, const float bpp_cutoff, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ fold_ensemble*& ensemble)
+{
+    ensemble = nullptr;
+
+    R_STATUS status = validate_sequence_view(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (!(bpp_cutoff >= 0.0f && bpp_cutoff <= 1.0f)) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    thread_local std::string terminated;
+    terminated.assign(sequence, length);
+
+    fold_ensemble* result = new fold_ensemble{};
+    status = fold_validated_sequence(terminated.c_str(), length, output, size, result, bpp_cutoff, context, FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        fold_ensemble_free(result);
+        return status;
+    }
+
+    ensemble = result;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Fold into caller-provided buffers
+ * Same structures and probabilities as `fold`, written as columns into memory
+ * owned by the caller, with no allocation per structure. Structure i is the
+ * null-terminated string at structures + i * (length + 1), by increasing energy.
+ * Only the first `capacity` structures are written; `size` is the number of
+ * structures of the fold, so a caller can grow its buffers when size > capacity.
+ *
+ * Understanding return values:
+ * - R_EMPTY_PARAMETER | capacity is not 0 and structures or probabilities is null
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Ribozyme sequence
+ * \param capacity Number of structures the buffers can hold
+ * \param structures Out buffer of capacity * (length + 1) characters
+ * \param probabilities Out buffer of capacity probabilities
+ * \param energies Out buffer of capacity free energies (kcal/mol), or nullptr to discard them
+ * \param size Out variable for the number of structures of the fold
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_into(const model_context* context, const char* sequence, const size_t capacity, /*out*/ char* structures, /*out*/ float* probabilities, /*out*/ float* energies, /*out*/ size_t& size)
+{
+    if (capacity != 0 && (structures == nullptr || probabilities == nullptr)) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+    R_STATUS status = validate_sequence(sequence);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    size_t length = strlen(sequence);
+
+    vrna_subopt_solution_t* sol = nullptr;
+    double energy, kT;
+    status = fold_solutions(sequence, length, sol, size, energy, kT, nullptr, 0.0f, context, FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    write_columns(sol, std::min(size, capacity), length, energy, kT, structures, probabilities, energies);
+    free_solutions(sol);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Fold into a single allocation
+ * Same structures and probabilities as `fold`, written as columns into one
+ * block of memory holding the arena and its columns, so the whole result can
+ * be copied out in one pass.
+ *
+ * Understanding return values:
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Ribozyme sequence
+ * \param arena Out variable for the fold columns, released with `fold_arena_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_arena_create(const model_context* context, const char* sequence, /*out*/ fold_arena*& arena)
+{
+    arena = nullptr;
+
+    R_STATUS status = validate_sequence(sequence);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    size_t length = strlen(sequence);
+
+    vrna_subopt_solution_t* sol = nullptr;
+    size_t count = 0;
+    double energy, kT;
+    status = fold_solutions(sequence, length, sol, count, energy, kT, nullptr, 0.0f, context, FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    // header, then the float columns, then the characters, so every column stays aligned
+    char* block = new char[sizeof(fold_arena) + 2 * count * sizeof(float) + count * (length + 1)];
+    arena = reinterpret_cast<fold_arena*>(block);
+    arena->count = count;
+    arena->stride = length + 1;
+    arena->probabilities = reinterpret_cast<float*>(block + sizeof(fold_arena));
+    arena->energies = arena->probabilities + count;
+    arena->structures = reinterpret_cast<char*>(arena->energies + count);
+
+    write_columns(sol, count, length, energy, kT, arena->structures, arena->probabilities, arena->energies);
+    free_solutions(sol);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from fold arena
+ *
+ ***************************************************************************************
+ * @param arena Fold columns to be freed
+ */
+DLL_PUBLIC void fold_arena_free(fold_arena* arena)
+{
+    delete[] reinterpret_cast<char*>(arena);
+}
+
+/*!
+ * \brief Free memory from fold ensemble data
+ *
+ ***************************************************************************************
+ * @param ensemble Ensemble data to be freed
+ */
+DLL_PUBLIC void fold_ensemble_free(fold_ensemble* ensemble)
+{
+    if (ensemble) {
+        delete[] ensemble->unpaired;
+        delete[] ensemble->centroid;
+        delete[] ensemble->pairs;
+        delete ensemble;
+    }
+}
+
+/*! \struct subopt_selection
+ * \brief Lowest energy suboptimal structures seen so far, bounded in number
+ */
+struct subopt_selection {
+    size_t max_structures; //!< Maximum number of structures to keep (0 for all)
+    std::vector<std::pair<float, std::string>> structures; //!< Max-heap on (energy, structure) once full
+    double kT; //!< Boltzmann factor unit (kcal/mol)
+    double reference; //!< Lowest energy seen so far
+    double weight; //!< Boltzmann weights of every structure seen, relative to the reference energy
+};
+
+/*!
+ * \brief Keep a suboptimal structure if it is among the lowest energies
+ * Called by `vrna_subopt_cb` for each structure, then with a null structure.
+ *
+ * \param structure Suboptimal structure, or null once done
+ * \param energy Free energy of the structure
+ * \param data Selection being filled
+ */
+static void select_subopt(const char* structure, float energy, void* data)
+{
+    if (structure == nullptr) {
+        return;
+    }
+
+    subopt_selection& selection = *static_cast<subopt_selection*>(data);
+
+    // every structure of the band counts towards the normalization, kept or not
+    if (selection.structures.empty() || energy < selection.reference) {
+        selection.weight = selection.structures.empty() ? 0.0 : selection.weight * std::exp((energy - selection.reference) / selection.kT);
+        selection.reference = energy;
+    }
+    selection.weight += std::exp((selection.reference - energy) / selection.kT);
+
+    if (selection.max_structures == 0 || selection.structures.size() < selection.max_structures) {
+        selection.structures.emplace_back(energy, structure);
+        if (selection.structures.size() == selection.max_structures) {
+            std::make_heap(selection.structures.begin(), selection.structures.end());
+        }
+    } else if (energy < selection.structures.front().first) {
+        std::pop_heap(selection.structures.begin(), selection.structures.end());
+        selection.structures.back() = { energy, structure };
+        std::push_heap(selection.structures.begin(), selection.structures.end());
+    }
+}
+
+/*! \struct subopt_stream
+ * \brief State of a streamed suboptimal enumeration
+ */
+struct subopt_stream {
+    fold_callback callback; //!< Consumer of the structures
+    void* data; //!< Consumer data
+    double energy; //!< Ensemble free energy
+    double kT; //!< Boltzmann factor unit (kcal/mol)
+    size_t max_structures; //!< Maximum number of structures to deliver (0 for all)
+    double probability_cutoff; //!< Cumulative probability after which to stop (0 for none)
+    double cumulative; //!< Probability delivered so far
+    size_t delivered; //!< Number of structures delivered so far
+    bool stopped; //!< Whether no more structures are delivered
+};
+
+/*!
+ * \brief Deliver a suboptimal structure to the consumer
+ * Called by `vrna_subopt_cb` for each structure, then with a null structure.
+ * ViennaRNA cannot be interrupted, so the remaining structures are skipped
+ * once a bound is reached or the consumer returns 0.
+ *
+ * \param structure Suboptimal structure, or null once done
+ * \param energy Free energy of the structure
+ * \param data Stream state
+ */
+static void stream_subopt(const char* structure, float energy, void* data)
+{
+    subopt_stream& stream = *static_cast<subopt_stream*>(data);
+    if (structure == nullptr || stream.stopped) {
+        return;
+    }
+
+    const double probability = std::exp((stream.energy - energy) / stream.kT);
+    stream.cumulative += probability;
+    stream.delivered++;
+
+    if (stream.callback(structure, static_cast<float>(probability), stream.data) == 0 ||
+        (stream.max_structures != 0 && stream.delivered >= stream.max_structures) ||
+        (stream.probability_cutoff > 0.0 && stream.cumulative >= stream.probability_cutoff)) {
+        stream.stopped = true;
+    }
+}
+
+/*!
+ * \brief Check the options of a bounded fold and compute its partition function
+ * The partition function is skipped with `FOLD_NORMALIZATION_SUBOPTIMAL`; the
+ * ensemble energy is then left to the caller.
+ *
+ * \param sequence Validated ribozyme sequence
+ * \param options Suboptimal enumeration bounds
+ * \param context Model context, or nullptr for the default model
+ * \param vc Out variable for the fold compound, released by the caller on success
+ * \param energy Out variable for the ensemble free energy
+ * \param kT Out variable for the Boltzmann factor unit (kcal/mol)
+ * \return Status Code
+ */
+static R_STATUS prepare_subopt(const char* sequence, const fold_options& options, const model_context* context, /*out*/ vrna_fold_compound_t*& vc, /*out*/ double& energy, /*out*/ double& kT)
+{
+    if (!(options.energy_band >= 0.0f) || !(options.probability_cutoff >= 0.0f && options.probability_cutoff <= 1.0f)) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    if (options.normalization != FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION &&
+        options.normalization != FOLD_NORMALIZATION::FOLD_NORMALIZATION_SUBOPTIMAL) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    const vrna_md_t* md = context_model_details(context);
+    vc = acquire_fold_compound(sequence, md);
+    context_prepare_mfe(vc, context);
+
+    if (options.normalization == FOLD_NORMALIZATION::FOLD_NORMALIZATION_SUBOPTIMAL) {
+        energy = 0.0;
+        kT = model_kT(md);
+        return R_SUCCESS::R_STATUS_OK;
+    }
+
+    context_prepare_pf(vc, context);
+    energy = vrna_pf(vc, NULL);
+
+    if (vc->exp_params == NULL || std::abs(vc->exp_params->kT / 1000.) < EPSILON) {
+        release_fold_compound(vc, md);
+        return R_SYSTEM_ERROR::R_VIENNA_RNA_ERROR;
+    }
+
+    kT = vc->exp_params->kT / 1000.;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Bounded fold of a validated sequence
+ * Same as `fold_with_options`, on a sequence already checked to hold only A, C, G and U.
+ *
+ * \param context Model context, or nullptr for the default model
+ * \param sequence Validated ribozyme sequence
+ * \param length Length of the sequence
+ * \param options Suboptimal enumeration bounds and normalization
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \param captured_probability Out variable for the probability of the returned structures
+ * \return Status Code
+ */
+static R_STATUS fold_validated_with_options(const model_context* context, const char* sequence, size_t length, const fold_options& options, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ float& captured_probability)
+{
+    vrna_fold_compound_t* vc = nullptr;
+    double energy, kT;
+    R_STATUS status = prepare_subopt(sequence, options, context, vc, energy, kT);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    subopt_selection selection{ options.max_structures, {}, kT, 0.0, 0.0 };
+    vrna_subopt_cb(vc, static_cast<int>(std::lround(options.energy_band * 100.0f)), &select_subopt, &selection);
+    release_fold_compound(vc, context_model_details(context));
+
+    if (options.normalization == FOLD_NORMALIZATION::FOLD_NORMALIZATION_SUBOPTIMAL && !selection.structures.empty()) {
+        // ensemble energy of the enumerated band only
+        energy = selection.reference - kT * std::log(selection.weight);
+    }
+
+    std::sort(selection.structures.begin(), selection.structures.end());
+
+    size_t kept = 0;
+    double cumulative = 0.0;
+    while (kept < selection.structures.size() &&
+           !(options.probability_cutoff > 0.0f && cumulative >= options.probability_cutoff)) {
+        cumulative += std::exp((energy - selection.structures[kept].first) / kT);
+        kept++;
+    }
+
+    size = kept;
+    output = new fold_output[kept];
+    for (size_t i = 0; i < kept; ++i) {
+        output[i].structure = new char[length + 1];
+        strncpy(output[i].structure, selection.structures[i].second.c_str(), length);
+        output[i].structure[length] = '\0';
+        output[i].probability = static_cast<float>(std::exp((energy - selection.structures[i].first) / kT));
+    }
+
+    captured_probability = static_cast<float>(cumulative);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Fold with bounded suboptimal enumeration
+ * Same as `fold`, with the energy band of the suboptimal structures (5 kcal/mol
+ * in `fold`), the maximum number of structures and a cumulative probability
+ * cutoff given by the caller. Structures are sorted by energy, as with `fold`;
+ * only the `max_structures` lowest energies are kept while enumerating, then
+ * structures are kept until their cumulative probability reaches the cutoff.
+ * With `FOLD_NORMALIZATION_SUBOPTIMAL`, the partition function is skipped and
+ * probabilities are normalized by the Boltzmann weights of every structure of
+ * the band, which roughly halves the cost of the fold.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | normalization is not a FOLD_NORMALIZATION
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | energy band is negative, or the cutoff is not within [0, 1]
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Ribozyme sequence
+ * \param options Suboptimal enumeration bounds and normalization
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \param captured_probability Out variable for the probability of the returned
+ * structures: of the whole ensemble, or of the enumerated band with `FOLD_NORMALIZATION_SUBOPTIMAL`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_with_options(const model_context* context, const char* sequence, const fold_options& options, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ float& captured_probability)
+{
+    size_t length;
+    R_STATUS status = validate_sequence_position(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    return fold_validated_with_options(context, sequence, length, options, output, size, captured_probability);
+}
+
+/*!
+ * \brief Fold of a view with bounded suboptimal enumeration
+ * Same as `fold_with_options`, on a sequence given by its length, which need
+ * not be terminated. ViennaRNA reads terminated strings, so the view is copied
+ * once into a buffer reused by the thread.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null, or normalization is not a FOLD_NORMALIZATION
+ * - R_EMPTY_PARAMETER | length is 0
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | energy band is negative, or the cutoff is not within [0, 1]
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Start of the ribozyme sequence
+ * \param length Length of the sequence
+ * \param options Suboptimal enumeration bounds and normalization
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \param captured_probability Out variable for the probability of the returned structures
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_with_options_view(const model_context* context, const char* sequence, const size_t length, const fold_options& options, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ float& captured_probability)
+{
+    R_STATUS status = validate_sequence_view(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    thread_local std::string terminated;
+    terminated.assign(sequence, length);
+
+    return fold_validated_with_options(context, terminated.c_str(), length, options, output, size, captured_probability);
+}
+
+/*!
+ * \brief Streamed fold
+ * Used to hand each suboptimal structure to the caller as ViennaRNA produces
+ * it, with its probability, without storing any of them. Structures are not
+ * sorted. Delivery stops after `max_structures` structures, once their cumulative
+ * probability reaches the cutoff, or when the callback returns 0.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | callback is null, or normalization is not FOLD_NORMALIZATION_PARTITION_FUNCTION
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | energy band is negative, or the cutoff is not within [0, 1]
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Ribozyme sequence
+ * \param options Suboptimal enumeration bounds
+ * \param callback Called with each structure and its probability; returns 0 to stop
+ * \param data Passed to the callback as is
+ * \param size Out variable for the number of structures delivered
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_stream(const model_context* context, const char* sequence, const fold_options& options, fold_callback callback, void* data, /*out*/ size_t& size)
+{
+    // probabilities of streamed structures must be known before the band is enumerated
+    if (callback == nullptr || options.normalization != FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    R_STATUS status = validate_sequence(sequence);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    vrna_fold_compound_t* vc = nullptr;
+    double energy, kT;
+    status = prepare_subopt(sequence, options, context, vc, energy, kT);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    subopt_stream stream{ callback, data, energy, kT, options.max_structures, options.probability_cutoff, 0.0, 0, false };
+    vrna_subopt_cb(vc, static_cast<int>(std::lround(options.energy_band * 100.0f)), &stream_subopt, &stream);
+    release_fold_compound(vc, context_model_details(context));
+
+    size = stream.delivered;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Sampled fold
+ * Used to fold the RNA sequence by drawing a fixed number of structures from
+ * the Boltzmann ensemble (stochastic backtracking), instead of enumerating
+ * every suboptimal structure. The cost after the partition function is linear
+ * in the number of samples, whatever the length of the sequence.
+ * Each unique structure is returned once, most probable first, with its
+ * estimated probability: its frequency among the samples. In non-redundant
+ * mode, structures are drawn with replacement until `samples` unique ones are
+ * found or after 8 draws per requested structure, so fewer than `samples`
+ * structures may be returned for ensembles dominated by a few structures. Each
+ * is returned with its exact Boltzmann probability, as frequencies are then
+ * meaningless. ViennaRNA's random number generator is shared, so the draws of
+ * concurrent calls are serialized: sampling does not scale across threads.
+ *
+ * Understanding return values:
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | samples is 0
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Ribozyme sequence
+ * \param samples Number of structures to draw (at most as many unique structures in non-redundant mode)
+ * \param non_redundant Whether to draw distinct structures only
+ * \param output Out variable for fold structures
+ * \param size Out variable for the size of the fold_output
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_sample(const model_context* context, const char* sequence, const size_t samples, const bool non_redundant, /*out*/ fold_output*& output, /*out*/ size_t& size)
+{
+    R_STATUS status = validate_sequence(sequence);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (samples == 0) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    size_t length = strlen(sequence);
+
+    // stochastic backtracking needs the unique multiloop decomposition, which the
+    // context's Boltzmann factors were not computed with, so they are computed again
+    vrna_md_t md;
+    if (context != nullptr) {
+        md = context->md;
+    } else {
+        vrna_md_set_default(&md);
+    }
+    md.uniq_ML = 1;
+
+    vrna_fold_compound_t *vc = acquire_fold_compound(sequence, &md);
+    float energy = vrna_pf(vc, NULL);
+
+    if (vc->exp_params == NULL || std::abs(vc->exp_params->kT / 1000.) < EPSILON) {
+        release_fold_compound(vc, &md);
+        return R_SYSTEM_ERROR::R_VIENNA_RNA_ERROR;
+    }
+
+    double kT = vc->exp_params->kT / 1000.;
+
+    std::unordered_map<std::string, size_t> counts;
+    {
+        std::lock_guard<std::mutex> lock(sampling_mutex);
+
+        const size_t draws = non_redundant ? samples * NON_REDUNDANT_DRAW_FACTOR : samples;
+        for (size_t i = 0; i < draws && !(non_redundant && counts.size() == samples); ++i) {
+            char* structure = vrna_pbacktrack(vc);
+            if (structure == nullptr) {
+                release_fold_compound(vc, &md);
+                return R_SYSTEM_ERROR::R_VIENNA_RNA_ERROR;
+            }
+
+            counts[structure]++;
+            free(structure);
+        }
+    }
+
+    std::vector<std::pair<float, std::string>> structures;
+    structures.reserve(counts.size());
+    for (const auto& [structure, count] : counts) {
+        float probability = non_redundant ?
+            static_cast<float>(std::exp((energy - vrna_eval_structure(vc, structure.c_str())) / kT)) :
+            static_cast<float>(count) / static_cast<float>(samples);
+        structures.emplace_back(probability, structure);
+    }
+
+    release_fold_compound(vc, &md);
+
+    // most probable first, ties in a stable order
+    std::sort(structures.begin(), structures.end(), [](const auto& a, const auto& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    });
+
+    size = structures.size();
+    output = new fold_output[size];
+    for (size_t i = 0; i < size; ++i) {
+        output[i].structure = new char[length + 1];
+        strncpy(output[i].structure, structures[i].second.c_str(), length);
+        output[i].structure[length] = '\0';
+        output[i].probability = structures[i].first;
+    }
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from fold outputs
+ * Used to free the memory from the fold structure
+ *
+ ***************************************************************************************
+ * @param output Fold structure to be freed
+ * @param size Size of the output
+ */
+DLL_PUBLIC void fold_output_free(fold_output* output, size_t size)
+{
+    if (output) {
+        for (size_t i = 0; i < size; ++i) {
+            delete[] output[i].structure;
+            output[i].structure = nullptr;
+        }
+
+        delete[] output;
+    }
+}
+
+/*!
+ * \brief Batched fold
+ * Used to fold a batch of RNA sequences in a single call, distributing the
+ * sequences across threads with OpenMP. Each sequence is folded exactly as
+ * with `fold` (or `fold_with_context`), and results are stored in input order.
+ *
+ * Understanding return values:
+ * - R_EMPTY_PARAMETER | sequences or one of the out arrays is null, or count is 0
+ * - statuses[i] holds the status code of `fold` for sequences[i]
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequences Array of ribozyme sequences
+ * \param count Number of sequences in the batch
+ * \param thread_count Number of threads to use (0 or less to use all available cores)
+ * \param outputs Out array of fold structures, one per sequence (nullptr on failure)
+ * \param sizes Out array of fold structure counts, one per sequence
+ * \param statuses Out array of status codes, one per sequence
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS fold_batch(const model_context* context, const char** sequences, const size_t count, const int thread_count, /*out*/ fold_output** outputs, /*out*/ size_t* sizes, /*out*/ R_STATUS* statuses)
+{
+    if (sequences == nullptr || outputs == nullptr || sizes == nullptr || statuses == nullptr || count == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+#ifdef _OPENMP
+    int threads = thread_count > 0 ? thread_count : omp_get_max_threads();
+
+    // fold times vary with sequence length, so hand out sequences dynamically
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+#else
+    (void)thread_count;
+#endif
+    for (long long i = 0; i < static_cast<long long>(count); ++i) {
+        outputs[i] = nullptr;
+        sizes[i] = 0;
+
+        if (sequences[i] == nullptr) {
+            statuses[i] = R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+            continue;
+        }
+
+        statuses[i] = fold_sequence(sequences[i], outputs[i], sizes[i], nullptr, 0.0f, context);
+        if (statuses[i] != R_SUCCESS::R_STATUS_OK) {
+            outputs[i] = nullptr;
+            sizes[i] = 0;
+        }
+    }
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from batched fold outputs
+ * Used to free the memory from every fold structure of a batch
+ *
+ ***************************************************************************************
+ * @param outputs Fold structures to be freed
+ * @param sizes Sizes of each output
+ * @param count Number of outputs in the batch
+ */
+DLL_PUBLIC void fold_batch_free(fold_output** outputs, size_t* sizes, const size_t count)
+{
+    if (outputs == nullptr || sizes == nullptr) {
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        fold_output_free(outputs[i], sizes[i]);
+        outputs[i] = nullptr;
+        sizes[i] = 0;
     }
 }
 
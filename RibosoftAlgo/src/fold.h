@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "functions.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+constexpr int MIN_BP_SPAN = 4; //!< Shortest span of a base pair enclosing a hairpin (minimum loop of 3)
+
+/*! \fn fold_validated_sequence
+ * \brief Suboptimal structures and probabilities of a validated sequence, optionally with ensemble data, in a model context
+ * @file fold.cpp
+ */
+R_STATUS fold_validated_sequence(const char* sequence, size_t length, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ fold_ensemble* ensemble, const float bpp_cutoff, const model_context* context, const int normalization);
+
+/*! \fn fold_ensemble_defect
+ * \brief Ensemble defect of a (validated) sequence to a pair table, from one partition function in a model context
+ * @file fold.cpp
+ */
+R_STATUS fold_ensemble_defect(const char* sequence, size_t length, const std::vector<int>& pairs, const model_context* context, /*out*/ double& defect);
+
+}
@@ -0,0 +1,358 @@
+#include "dll.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <ViennaRNA/data_structures.h>
+
+#include "functions.h"
+#include "fold_pool.h"
+
+extern "C" {
+    /**
+     *  @brief  Retrieve a vrna_fold_compound_t data structure for single sequences and hybridizing sequences
+     *
+     *  @param    sequence    A single sequence, or two concatenated sequences seperated by an '&' character
+     *  @param    md_p        An optional set of model details
+     *  @param    options     The options for DP matrices memory allocation
+     *  @return               A prefilled vrna_fold_compound_t that can be readily used for computations
+     */
+    vrna_fold_compound_t* vrna_fold_compound(const char* sequence, vrna_md_t* md_p, unsigned int options);
+
+    /**
+     *  @brief Apply default model details to a provided #vrna_md_t data structure
+     *
+     *  @param md A pointer to the data structure that is about to be initialized
+     */
+    void vrna_md_set_default(vrna_md_t* md);
+
+    /**
+     *  @brief  Get a numerical representation of the nucleotide sequence (with aliases)
+     *
+     *  @param  sequence  The input sequence in upper-case letters
+     *  @param  md        A pointer to a #vrna_md_t data structure that specifies the conversion type
+     *  @return           A list of integer encodings for each sequence letter (1-based)
+     */
+    short* vrna_seq_encode(const char* sequence, vrna_md_t* md);
+
+    /**
+     *  @brief  Get a numerical representation of the nucleotide sequence (simple)
+     *
+     *  @param  sequence  The input sequence in upper-case letters
+     *  @param  md        A pointer to a #vrna_md_t data structure that specifies the conversion type
+     *  @return           A list of integer encodings for each sequence letter (1-based), the length at 0
+     */
+    short* vrna_seq_encode_simple(const char* sequence, vrna_md_t* md);
+
+    /**
+     *  @brief Get an array of the numerical encoding for each possible base pair (i,j)
+     *
+     *  @param  S   The simple encoding of the sequence
+     *  @param  md  Model details
+     *  @return     Base pair types, indexed like the MFE matrices
+     */
+    char* vrna_ptypes(const short* S, vrna_md_t* md);
+
+    /**
+     *  @brief Get an array of the numerical encoding for each possible base pair (i,j), in the layout of the partition function
+     *
+     *  @param  S         The simple encoding of the sequence
+     *  @param  md        Model details
+     *  @param  idx_type  Index layout (1 for the partition function)
+     *  @return           Base pair types
+     */
+    char* get_ptypes(const short* S, vrna_md_t* md, unsigned int idx_type);
+
+    /**
+     *  @brief Initialize/Reset hard constraints to default values
+     *
+     *  @param  vc  The fold compound whose hard constraints follow its sequence again
+     */
+    void vrna_hc_init(vrna_fold_compound_t* vc);
+}
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+constexpr size_t FOLD_POOL_DEFAULT_BYTES = 0; //!< Default bound on the pooled fold compounds of each thread (pooling is opt-in)
+constexpr size_t FOLD_POOL_BYTES_PER_CELL = 48; //!< Estimated bytes per (i, j) cell of the MFE and PF matrices
+
+/*! \struct pooled_compound
+ * \brief Fold compound released for reuse
+ */
+struct pooled_compound {
+    vrna_fold_compound_t* vc; //!< Fold compound, with its energy parameters and DP matrices
+    vrna_md_t md; //!< Model details the fold compound was created with
+    size_t bytes; //!< Estimated size of its matrices
+};
+
+std::atomic<size_t> fold_pool_bytes_limit{FOLD_POOL_DEFAULT_BYTES}; //!< Bound on the pooled fold compounds of each thread
+std::atomic<uint64_t> fold_pool_hits{0}; //!< Number of pooled fold compounds reused
+std::atomic<uint64_t> fold_pool_misses{0}; //!< Number of fold compounds created
+std::atomic<size_t> fold_pool_bytes{0}; //!< Estimated size of the fold compounds pooled by every thread
+
+/*!
+ * \brief Free a pooled fold compound
+ *
+ * \param compound Pooled fold compound
+ */
+static void free_compound(pooled_compound& compound)
+{
+    vrna_fold_compound_free(compound.vc);
+    fold_pool_bytes.fetch_sub(compound.bytes, std::memory_order_relaxed);
+}
+
+struct compound_pool;
+
+std::mutex pool_registry_mutex; //!< Mutex to lock access to the pool registry
+std::vector<compound_pool*> pool_registry; //!< Pool of every live thread
+
+/*! \struct compound_pool
+ * \brief Fold compounds pooled by one thread, oldest first
+ * The owning thread is the only one to add or take fold compounds; the mutex
+ * is only contended when another thread clears every pool.
+ */
+struct compound_pool {
+    std::mutex mutex; //!< Mutex to lock access to this pool
+    size_t bytes = 0; //!< Estimated size of the pooled fold compounds
+    std::vector<pooled_compound> entries; //!< Pooled fold compounds
+
+    compound_pool()
+    {
+        std::lock_guard<std::mutex> lock(pool_registry_mutex);
+        pool_registry.push_back(this);
+    }
+
+    ~compound_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(pool_registry_mutex);
+            pool_registry.erase(std::find(pool_registry.begin(), pool_registry.end(), this));
+        }
+        clear();
+    }
+
+    /*!
+     * \brief Free every pooled fold compound, with the mutex held
+     */
+    void clear()
+    {
+        for (pooled_compound& compound : entries) {
+            free_compound(compound);
+        }
+        entries.clear();
+        bytes = 0;
+    }
+};
+
+thread_local compound_pool pool; //!< Fold compounds pooled by the calling thread
+
+/*!
+ * \brief Model details of a fold
+ *
+ * \param md Model details, or nullptr for the defaults
+ * \param model Out variable for the model details
+ */
+static void model_details(const vrna_md_t* md, /*out*/ vrna_md_t& model)
+{
+    if (md != nullptr) {
+        model = *md;
+    } else {
+        vrna_md_set_default(&model);
+    }
+}
+
+/*!
+ * \brief Whether two sets of model details give the same fold compound
+ * Every detail the energy parameters or the DP matrices depend on is
+ * compared, the temperature included.
+ *
+ * \param first Model details of the pooled fold compound
+ * \param second Model details of the fold
+ * \return True if the pooled fold compound can fold under the second model details
+ */
+static bool same_model(const vrna_md_t& first, const vrna_md_t& second)
+{
+    return first.temperature == second.temperature &&
+           first.betaScale == second.betaScale &&
+           first.dangles == second.dangles &&
+           first.special_hp == second.special_hp &&
+           first.noLP == second.noLP &&
+           first.noGU == second.noGU &&
+           first.noGUclosure == second.noGUclosure &&
+           first.logML == second.logML &&
+           first.circ == second.circ &&
+           first.gquad == second.gquad &&
+           first.uniq_ML == second.uniq_ML &&
+           first.energy_set == second.energy_set &&
+           first.backtrack == second.backtrack &&
+           first.backtrack_type == second.backtrack_type &&
+           first.compute_bpp == second.compute_bpp &&
+           first.max_bp_span == second.max_bp_span &&
+           first.min_loop_size == second.min_loop_size &&
+           first.window_size == second.window_size &&
+           first.oldAliEn == second.oldAliEn &&
+           first.ribo == second.ribo &&
+           first.cv_fact == second.cv_fact &&
+           first.nc_fact == second.nc_fact &&
+           first.sfact == second.sfact;
+}
+
+/*!
+ * \brief Give a pooled fold compound another sequence of the same length
+ * Only the sequence encodings, pair types and hard constraints depend on the
+ * sequence; the energy parameters, index arrays and DP matrices are kept,
+ * and the matrices are overwritten by the next fold.
+ *
+ * \param vc Pooled fold compound
+ * \param sequence Validated sequence of the same length
+ * \param model Model details the fold compound was created with
+ */
+static void assign_sequence(vrna_fold_compound_t* vc, const char* sequence, vrna_md_t& model)
+{
+    memcpy(vc->sequence, sequence, vc->length);
+
+    free(vc->sequence_encoding);
+    free(vc->sequence_encoding2);
+    vc->sequence_encoding = vrna_seq_encode(vc->sequence, &model);
+    vc->sequence_encoding2 = vrna_seq_encode_simple(vc->sequence, &model);
+
+    if (vc->ptype != nullptr) {
+        free(vc->ptype);
+        vc->ptype = vrna_ptypes(vc->sequence_encoding2, &model);
+    }
+
+    if (vc->ptype_pf_compat != nullptr) {
+        free(vc->ptype_pf_compat);
+        vc->ptype_pf_compat = get_ptypes(vc->sequence_encoding2, &model, 1);
+    }
+
+    vrna_hc_init(vc);
+}
+
+/*!
+ * \brief Pooled fold compound
+ * A fold compound released by the calling thread for the same sequence length
+ * and model details (see `same_model`) is given the new sequence, so neither
+ * its energy parameters nor its DP matrices are allocated again; otherwise a
+ * new fold compound is created.
+ *
+ * \param sequence Validated sequence
+ * \param md Model details, or nullptr for the defaults
+ * \return Fold compound, released with `release_fold_compound`
+ */
+vrna_fold_compound_t* acquire_fold_compound(const char* sequence, const vrna_md_t* md)
+{
+    vrna_md_t model;
+    model_details(md, model);
+
+    if (fold_pool_bytes_limit.load() > 0) {
+        const size_t length = strlen(sequence);
+
+        std::lock_guard<std::mutex> lock(pool.mutex);
+        for (auto entry = pool.entries.rbegin(); entry != pool.entries.rend(); ++entry) {
+            if (entry->vc->length == length && same_model(entry->md, model)) {
+                vrna_fold_compound_t* vc = entry->vc;
+                assign_sequence(vc, sequence, model);
+
+                pool.bytes -= entry->bytes;
+                fold_pool_bytes.fetch_sub(entry->bytes, std::memory_order_relaxed);
+                pool.entries.erase(std::next(entry).base());
+
+                fold_pool_hits.fetch_add(1, std::memory_order_relaxed);
+                return vc;
+            }
+        }
+    }
+
+    fold_pool_misses.fetch_add(1, std::memory_order_relaxed);
+    return vrna_fold_compound(sequence, &model, VRNA_OPTION_DEFAULT);
+}
+
+/*!
+ * \brief Release a fold compound
+ * It is kept for the next fold of the same length and model details,
+ * evicting the oldest pooled fold compounds past the bound of the calling thread.
+ *
+ * \param vc Fold compound from `acquire_fold_compound`
+ * \param md Model details the fold compound was acquired with
+ */
+void release_fold_compound(vrna_fold_compound_t* vc, const vrna_md_t* md)
+{
+    const size_t limit = fold_pool_bytes_limit.load();
+    const size_t length = vc->length;
+    const size_t bytes = length * (length + 1) / 2 * FOLD_POOL_BYTES_PER_CELL;
+
+    if (bytes > limit) {
+        vrna_fold_compound_free(vc);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    while (pool.bytes + bytes > limit) {
+        pool.bytes -= pool.entries.front().bytes;
+        free_compound(pool.entries.front());
+        pool.entries.erase(pool.entries.begin());
+    }
+
+    pooled_compound compound{ vc, {}, bytes };
+    model_details(md, compound.md);
+    pool.entries.push_back(compound);
+    pool.bytes += bytes;
+    fold_pool_bytes.fetch_add(bytes, std::memory_order_relaxed);
+}
+
+/*!
+ * \brief Configure the fold compound pool
+ * Used to bound the estimated size of the fold compounds (energy parameters
+ * and DP matrices) each thread keeps for reuse. Pooling is disabled (a bound
+ * of 0) until this is called with a non-zero bound; every pool is cleared.
+ *
+ ***************************************************************************************
+ * \param max_bytes Maximum size of the pooled fold compounds of each thread
+ */
+DLL_PUBLIC void fold_pool_configure(const size_t max_bytes)
+{
+    fold_pool_bytes_limit.store(max_bytes);
+    fold_pool_clear();
+}
+
+/*!
+ * \brief Clear the fold compound pool
+ * Used to free the pooled fold compounds of every thread and reset the counters.
+ *
+ ***************************************************************************************
+ */
+DLL_PUBLIC void fold_pool_clear()
+{
+    std::lock_guard<std::mutex> registry_lock(pool_registry_mutex);
+    for (compound_pool* thread_pool : pool_registry) {
+        std::lock_guard<std::mutex> lock(thread_pool->mutex);
+        thread_pool->clear();
+    }
+
+    fold_pool_hits.store(0);
+    fold_pool_misses.store(0);
+}
+
+/*!
+ * \brief Fold compound pool statistics
+ *
+ ***************************************************************************************
+ * \param hits Out variable for the number of folds that reused a pooled fold compound
+ * \param misses Out variable for the number of folds that created their own fold compound
+ * \param bytes Out variable for the estimated size of the fold compounds pooled by every thread
+ */
+DLL_PUBLIC void fold_pool_stats(/*out*/ uint64_t& hits, /*out*/ uint64_t& misses, /*out*/ size_t& bytes)
+{
+    hits = fold_pool_hits.load();
+    misses = fold_pool_misses.load();
+    bytes = fold_pool_bytes.load();
+}
+
+}
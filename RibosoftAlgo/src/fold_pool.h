@@ -0,0 +1,20 @@
+#pragma once
+
+#include <ViennaRNA/data_structures.h>
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*! \fn acquire_fold_compound
+ * \brief Fold compound of a (validated) sequence, reusing a fold compound pooled by the calling thread
+ * @file fold_pool.cpp
+ */
+vrna_fold_compound_t* acquire_fold_compound(const char* sequence, const vrna_md_t* md);
+
+/*! \fn release_fold_compound
+ * \brief Free a fold compound from `acquire_fold_compound`, keeping it in the calling thread's pool
+ * @file fold_pool.cpp
+ */
+void release_fold_compound(vrna_fold_compound_t* vc, const vrna_md_t* md);
+
+}
@@ -24,8 +24,126 @@ struct fold_output {
     char* structure; //!< Secondary structure from folding
     float probability; //!< Probability of structure in the free energy distribution
 };
+
+/*! \enum FOLD_NORMALIZATION
+ * \brief Normalization of fold probabilities
+ */
+enum FOLD_NORMALIZATION : int {
+    FOLD_NORMALIZATION_PARTITION_FUNCTION = 0, //!< Exact, by the partition function of the whole ensemble (default)
+    FOLD_NORMALIZATION_SUBOPTIMAL         = 1, //!< Approximate, by the Boltzmann weights of the enumerated band
+};
+
+/*! \struct fold_options
+ * \brief Bounds of the suboptimal structure enumeration of a fold
+ */
+struct fold_options {
+    float energy_band; //!< Energy band above the MFE (kcal/mol); `fold` uses 5
+    size_t max_structures; //!< Maximum number of structures (0 for no maximum)
+    float probability_cutoff; //!< Stop once the structures add up to this probability (0 for no cutoff)
+    int normalization; //!< FOLD_NORMALIZATION of the probabilities
+};
+
+/*! \struct fold_pair
+ * \brief Base pair (0-based, i < j) and its probability in the ensemble
+ */
+struct fold_pair {
+    int i; //!< 5' position of the pair
+    int j; //!< 3' position of the pair
+    float probability; //!< Probability of the pair in the ensemble
+};
+
+/*! \struct fold_ensemble
+ * \brief Ensemble data from the partition function of a fold
+ */
+struct fold_ensemble {
+    float energy; //!< Ensemble free energy (kcal/mol)
+    float* unpaired; //!< Probability of each position to be unpaired
+    char* centroid; //!< Centroid structure
+    fold_pair* pairs; //!< Base pairs above the probability cutoff
+    size_t pair_count; //!< Number of listed base pairs
+};
+
+/*! \struct fold_arena
+ * \brief Fold structures as columns, allocated with the arena in a single block
+ */
+struct fold_arena {
+    size_t count; //!< Number of structures
+    size_t stride; //!< Characters per structure, including the null terminator
+    float* probabilities; //!< Probability of each structure in the free energy distribution
+    float* energies; //!< Free energy of each structure (kcal/mol)
+    char* structures; //!< Structure i is the null-terminated string at structures + i * stride
+};
 #pragma pack(pop)
 
+/*! \typedef fold_callback
+ * \brief Consumer of streamed fold structures: returns 0 to stop receiving structures
+ */
+typedef int (*fold_callback)(const char* structure, float probability, void* data);
+
+/*! \typedef local_fold_callback
+ * \brief Consumer of streamed local structures (0-based start, length): returns 0 to stop receiving structures
+ */
+typedef int (*local_fold_callback)(size_t start, size_t length, const char* structure, float energy, void* data);
+
+/*! \typedef unpaired_callback
+ * \brief Consumer of streamed unpaired probabilities of a position: returns 0 to stop receiving probabilities
+ */
+typedef int (*unpaired_callback)(size_t position, const float* probabilities, size_t count, void* data);
+
+/*! \struct model_context
+ * \brief Opaque handle to the folding and annealing conditions of a job, with precomputed energy parameters
+ */
+struct model_context;
+
+/*! \struct target_context
+ * \brief Opaque handle to a target RNA validated and packed once, for the melting temperatures of its substrings
+ */
+struct target_context;
+
+/*! \struct substrate_template
+ * \brief Opaque handle to the binding arms of a substrate structure, compiled once per ribozyme structure
+ */
+struct substrate_template;
+
+/*! \struct pairing_index
+ * \brief Opaque handle to the paired positions of a folded RNA, for constant-time single-strandedness checks
+ */
+struct pairing_index;
+
+/*! \struct unpaired_profile
+ * \brief Opaque handle to the unpaired probabilities of the stretches of an RNA, for constant-time ensemble accessibility
+ */
+struct unpaired_profile;
+
+/*! \enum STRUCTURE_SCORE_MODE
+ * \brief Structure score methods
+ */
+enum STRUCTURE_SCORE_MODE : int {
+    STRUCTURE_SCORE_SUBOPT           = 0, //!< Tree edit distance of the suboptimal structures, weighted by probability (default)
+    STRUCTURE_SCORE_ENSEMBLE_DEFECT  = 1, //!< Ensemble defect from the base pair probabilities
+    STRUCTURE_SCORE_SUBOPT_BAND      = 2, //!< As STRUCTURE_SCORE_SUBOPT, normalized by the enumerated band (see FOLD_NORMALIZATION_SUBOPTIMAL)
+};
+
+/*! \struct structure_ideal
+ * \brief Opaque handle to an ideal secondary structure parsed for repeated comparisons
+ */
+struct structure_ideal;
+
+/*! \struct validated_sequence
+ * \brief Opaque handle to a sequence validated once, for the exports that take it without checking it again
+ */
+struct validated_sequence;
+
+/*! \struct validated_structure
+ * \brief Opaque handle to a dot-bracket structure validated once, with its pair table
+ */
+struct validated_structure;
+
+/*! \struct packed_sequence
+ * \brief Opaque handle to a sequence validated once and held with 2 bits per nucleotide
+ */
+struct packed_sequence;
+
 /*! \fn validate_sequence
  * \brief validate_sequence
  * Validation function used to confirm that sequence contains only base nucleotides (A,C,G,U)
@@ -33,6 +151,20 @@ struct fold_output {
  */
 extern "C" DLL_PUBLIC R_STATUS validate_sequence(const char* sequence);
 
+/*! \fn validate_sequence_view
+ * \brief validate_sequence_view
+ * Validation of a sequence given by its length, not necessarily terminated
+ * @file validation.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS validate_sequence_view(const char* sequence, const size_t length);
+
+/*! \fn validate_sequence_position
+ * \brief validate_sequence_position
+ * Function to validate a sequence and find its first invalid nucleotide
+ * @file validation.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS validate_sequence_position(const char* sequence, /*out*/ size_t& position);
+
 /*! \fn validate_structure
  * \brief validate_structure
  * Validation function used to confirm that structure has proper bonds
@@ -40,6 +172,83 @@ extern "C" DLL_PUBLIC R_STATUS validate_sequence(const char* sequence);
  */
 extern "C" DLL_PUBLIC R_STATUS validate_structure(const char* structure);
 
+/*! \fn validate_structure_view
+ * \brief validate_structure_view
+ * Validation of a structure given by its length, not necessarily terminated
+ * @file validation.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS validate_structure_view(const char* structure, const size_t length);
+
+/*! \fn validate_structure_pairs
+ * \brief validate_structure_pairs
+ * Validation function returning the pair table of a structure
+ * @file validation.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS validate_structure_pairs(const char* structure, /*out*/ int*& pairs, /*out*/ size_t& length);
+
+/*! \fn pair_table_free
+ * \brief pair_table_free
+ * Function to free pair table memory
+ * @file validation.cpp
+ */
+extern "C" DLL_PUBLIC void pair_table_free(int* pairs);
+
+/*! \fn validated_sequence_create
+ * \brief validated_sequence_create
+ * Validate a sequence once, for the `*_validated` exports
+ * @file validation.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS validated_sequence_create(const char* sequence, /*out*/ validated_sequence*& handle);
+
+/*! \fn validated_sequence_free
+ * \brief validated_sequence_free
+ * Function to free validated sequence memory
+ * @file validation.cpp
+ */
+extern "C" DLL_PUBLIC void validated_sequence_free(validated_sequence* handle);
+
+/*! \fn validated_structure_create
+ * \brief validated_structure_create
+ * Validate a structure once, for the `*_validated` exports
+ * @file validation.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS validated_structure_create(const char* structure, /*out*/ validated_structure*& handle);
+
+/*! \fn validated_structure_free
+ * \brief validated_structure_free
+ * Function to free validated structure memory
+ * @file validation.cpp
+ */
+extern "C" DLL_PUBLIC void validated_structure_free(validated_structure* handle);
+
+/*! \fn packed_sequence_create
+ * \brief packed_sequence_create
+ * Validate a sequence and pack it with 2 bits per nucleotide
+ * @file packed_sequence.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS packed_sequence_create(const char* sequence, /*out*/ packed_sequence*& handle);
+
+/*! \fn packed_sequence_window
+ * \brief packed_sequence_window
+ * Read up to 32 nucleotides of a packed sequence into one integer
+ * @file packed_sequence.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS packed_sequence_window(const packed_sequence* handle, const size_t start, const size_t length, /*out*/ uint64_t& window);
+
+/*! \fn packed_sequence_unpack
+ * \brief packed_sequence_unpack
+ * Write a range of a packed sequence as characters
+ * @file packed_sequence.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS packed_sequence_unpack(const packed_sequence* handle, const size_t start, const size_t length, /*out*/ char* sequence);
+
+/*! \fn packed_sequence_free
+ * \brief packed_sequence_free
+ * Function to free packed sequence memory
+ * @file packed_sequence.cpp
+ */
+extern "C" DLL_PUBLIC void packed_sequence_free(packed_sequence* handle);
+
 /*! \fn accessibility
  * \brief accessibility
  * Accessibility of cutsite on the substrate
@@ -47,6 +256,118 @@ extern "C" DLL_PUBLIC R_STATUS validate_structure(const char* structure);
  */
 extern "C" DLL_PUBLIC R_STATUS accessibility(const char* substrate_sequence, const char* substrate_structure, const char* folded_structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& score);
 
+/*! \fn accessibility_view
+ * \brief accessibility_view
+ * Accessibility of cutsite on the substrate, on strings given by their length
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS accessibility_view(const char* substrate_sequence, const size_t sequence_length, const char* substrate_structure, const size_t structure_length, const char* folded_structure, const size_t folded_length, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& score);
+
+/*! \fn accessibility_validated
+ * \brief accessibility_validated
+ * Accessibility of a validated sequence against a substrate template
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS accessibility_validated(const validated_sequence* substrate_sequence, const substrate_template* substrate_structure, const char* folded_structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& score);
+
+/*! \fn candidate_score
+ * \brief candidate_score
+ * Annealing temperature and accessibility at every cutsite of a candidate, in one call
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS candidate_score(const model_context* context, const char* substrate_sequence, const char* substrate_structure, const char* rna_structure, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores);
+
+/*! \fn candidate_score_view
+ * \brief candidate_score_view
+ * Annealing temperature and accessibility at every cutsite of a candidate given by its length
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS candidate_score_view(const model_context* context, const char* substrate_sequence, const size_t sequence_length, const char* substrate_structure, const size_t structure_length, const char* rna_structure, const size_t rna_length, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores);
+
+/*! \fn candidate_score_indexed
+ * \brief candidate_score_indexed
+ * Annealing temperature and accessibility at every cutsite of a candidate, on an indexed RNA
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS candidate_score_indexed(const model_context* context, const char* substrate_sequence, const char* substrate_structure, const pairing_index* index, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores);
+
+/*! \fn candidate_score_indexed_view
+ * \brief candidate_score_indexed_view
+ * Annealing temperature and accessibility at every cutsite of a candidate given by its length, on an indexed RNA
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS candidate_score_indexed_view(const model_context* context, const char* substrate_sequence, const size_t sequence_length, const char* substrate_structure, const size_t structure_length, const pairing_index* index, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores);
+
+/*! \fn candidate_score_validated
+ * \brief candidate_score_validated
+ * Annealing temperature and accessibility at every cutsite of a validated candidate, on an indexed RNA
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS candidate_score_validated(const model_context* context, const validated_sequence* substrate_sequence, const substrate_template* substrate_structure, const pairing_index* index, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores);
+
+/*! \fn candidate_score_profiled
+ * \brief candidate_score_profiled
+ * Annealing temperature and ensemble accessibility at every cutsite of a candidate, on a profiled RNA
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS candidate_score_profiled(const model_context* context, const char* substrate_sequence, const char* substrate_structure, const unpaired_profile* profile, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores);
+
+/*! \fn candidate_score_profiled_view
+ * \brief candidate_score_profiled_view
+ * Annealing temperature and ensemble accessibility at every cutsite of a candidate given by its length, on a profiled RNA
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS candidate_score_profiled_view(const model_context* context, const char* substrate_sequence, const size_t sequence_length, const char* substrate_structure, const size_t structure_length, const unpaired_profile* profile, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores);
+
+/*! \fn pairing_index_create
+ * \brief pairing_index_create
+ * Index the paired positions of a folded RNA once
+ * @file pairing_index.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS pairing_index_create(const char* folded_structure, /*out*/ pairing_index*& handle);
+
+/*! \fn pairing_index_create_view
+ * \brief pairing_index_create_view
+ * Index the paired positions of a folded RNA given by its length
+ * @file pairing_index.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS pairing_index_create_view(const char* folded_structure, const size_t length, /*out*/ pairing_index*& handle);
+
+/*! \fn pairing_index_unpaired
+ * \brief pairing_index_unpaired
+ * Whether a range of an indexed RNA is single stranded
+ * @file pairing_index.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS pairing_index_unpaired(const pairing_index* handle, const size_t start, const size_t length, /*out*/ bool& unpaired);
+
+/*! \fn pairing_index_free
+ * \brief pairing_index_free
+ * Function to free pairing index memory
+ * @file pairing_index.cpp
+ */
+extern "C" DLL_PUBLIC void pairing_index_free(pairing_index* handle);
+
+/*! \fn unpaired_profile_create
+ * \brief unpaired_profile_create
+ * Profile the unpaired probabilities of the stretches of an RNA once
+ * @file unpaired_profile.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS unpaired_profile_create(const model_context* context, const char* rna_sequence, const int* stretch_lengths, const size_t count, const int window_size, const int max_bp_span, /*out*/ unpaired_profile*& handle);
+
+/*! \fn unpaired_profile_probability
+ * \brief unpaired_profile_probability
+ * Probability that a stretch of a profiled RNA is unpaired
+ * @file unpaired_profile.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS unpaired_profile_probability(const unpaired_profile* handle, const size_t start, const size_t length, /*out*/ float& probability);
+
+/*! \fn unpaired_profile_free
+ * \brief unpaired_profile_free
+ * Function to free unpaired profile memory
+ * @file unpaired_profile.cpp
+ */
+extern "C" DLL_PUBLIC void unpaired_profile_free(unpaired_profile* handle);
+
 
 /*! \fn anneal
  * \brief anneal
@@ -55,6 +376,118 @@ extern "C" DLL_PUBLIC R_STATUS accessibility(const char* substrate_sequence, con
  */
 extern "C" DLL_PUBLIC R_STATUS anneal(const char* sequence, const char* structure, const float na_concentration, const float probe_concentration, const float target_temp, float& temp);
 
+/*! \fn anneal_view
+ * \brief anneal_view
+ * Annealing temperature of binding regions for ribozyme, on strings given by their length
+ * @file anneal.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS anneal_view(const char* sequence, const size_t sequence_length, const char* structure, const size_t structure_length, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temp);
+
+/*! \fn anneal_with_context
+ * \brief anneal_with_context
+ * Annealing temperature of binding regions for ribozyme, at the concentrations and temperature of a model context
+ * @file anneal.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS anneal_with_context(const model_context* context, const char* sequence, const char* structure, /*out*/ float& temp);
+
+/*! \fn anneal_validated
+ * \brief anneal_validated
+ * Annealing temperature of a validated sequence against a substrate template
+ * @file anneal.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS anneal_validated(const validated_sequence* sequence, const substrate_template* structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temp);
+
+/*! \fn melting_temperature
+ * \brief melting_temperature
+ * Memoized MELTING temperature of a sequence with its complement
+ * @file anneal.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS melting_temperature(const char* sequence, const float na_concentration, const float probe_concentration, /*out*/ float& temp);
+
+/*! \fn melting_cache_configure
+ * \brief melting_cache_configure
+ * Bound (or disable with 0) the memoized MELTING temperatures
+ * @file anneal.cpp
+ */
+extern "C" DLL_PUBLIC void melting_cache_configure(const size_t max_entries);
+
+/*! \fn melting_cache_clear
+ * \brief melting_cache_clear
+ * Clear the memoized MELTING temperatures and counters
+ * @file anneal.cpp
+ */
+extern "C" DLL_PUBLIC void melting_cache_clear();
+
+/*! \fn melting_cache_stats
+ * \brief melting_cache_stats
+ * Hit and miss counters and size of the memoized MELTING temperatures
+ * @file anneal.cpp
+ */
+extern "C" DLL_PUBLIC void melting_cache_stats(/*out*/ uint64_t& hits, /*out*/ uint64_t& misses, /*out*/ size_t& entries);
+
+/*! \fn target_context_create
+ * \brief target_context_create
+ * Validate and pack a target RNA once for the melting temperatures of its substrings
+ * @file target_context.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS target_context_create(const char* rna, /*out*/ target_context*& context);
+
+/*! \fn target_context_melting
+ * \brief target_context_melting
+ * Melting temperature of a substring of the target RNA
+ * @file target_context.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS target_context_melting(const target_context* context, const size_t start, const size_t length, const float na_concentration, const float probe_concentration, /*out*/ float& temp);
+
+/*! \fn target_context_anneal
+ * \brief target_context_anneal
+ * Annealing temperature of binding regions for a substrate on the target RNA
+ * @file target_context.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS target_context_anneal(const target_context* context, const size_t offset, const char* substrate_structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temp);
+
+/*! \fn target_context_candidate_score
+ * \brief target_context_candidate_score
+ * Candidate score across all its cutsites, with the substrate read in place on a target context
+ * @file accessibility.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS target_context_candidate_score(const model_context* context, const target_context* target, const char* substrate_structure, const pairing_index* index, const int* cutsite_indices, const size_t cutsite_count, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temperature_score, /*out*/ float* accessibility_scores);
+
+/*! \fn target_context_free
+ * \brief target_context_free
+ * Function to free target context memory
+ * @file target_context.cpp
+ */
+extern "C" DLL_PUBLIC void target_context_free(target_context* context);
+
+/*! \fn substrate_template_create
+ * \brief substrate_template_create
+ * Compile the binding arms of a substrate structure once
+ * @file substrate_template.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS substrate_template_create(const char* substrate_structure, /*out*/ substrate_template*& handle);
+
+/*! \fn substrate_template_anneal
+ * \brief substrate_template_anneal
+ * Annealing temperature of binding regions for a substrate sequence against a compiled template
+ * @file substrate_template.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS substrate_template_anneal(const substrate_template* handle, const char* sequence, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temp);
+
+/*! \fn substrate_template_accessibility
+ * \brief substrate_template_accessibility
+ * Accessibility of a substrate sequence against a compiled template
+ * @file substrate_template.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS substrate_template_accessibility(const substrate_template* handle, const char* substrate_sequence, const char* folded_structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& score);
+
+/*! \fn substrate_template_free
+ * \brief substrate_template_free
+ * Function to free substrate template memory
+ * @file substrate_template.cpp
+ */
+extern "C" DLL_PUBLIC void substrate_template_free(substrate_template* handle);
+
 /*! \fn fold
  * \brief fold
  * Fold function used to fold sequence with ViennaRNA
@@ -62,6 +495,13 @@ extern "C" DLL_PUBLIC R_STATUS anneal(const char* sequence, const char* structur
  */
 extern "C" DLL_PUBLIC R_STATUS fold(const char* sequence, /*out*/ fold_output*& output, /*out*/ size_t& size);
 
+/*! \fn fold_view
+ * \brief fold_view
+ * Fold a sequence given by its length with ViennaRNA
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_view(const model_context* context, const char* sequence, const size_t length, /*out*/ fold_output*& output, /*out*/ size_t& size);
+
 /*! \fn fold_output_free
  * \brief fold_output_free
  * Function to free fold structure memory
@@ -69,6 +509,128 @@ extern "C" DLL_PUBLIC R_STATUS fold(const char* sequence, /*out*/ fold_output*&
  */
 extern "C" DLL_PUBLIC void fold_output_free(fold_output* output, size_t size);
 
+/*! \fn fold_with_context
+ * \brief fold_with_context
+ * Fold function used to fold sequence with ViennaRNA, in a model context
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_with_context(const model_context* context, const char* sequence, /*out*/ fold_output*& output, /*out*/ size_t& size);
+
+/*! \fn fold_validated
+ * \brief fold_validated
+ * Fold a validated sequence
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_validated(const model_context* context, const validated_sequence* sequence, /*out*/ fold_output*& output, /*out*/ size_t& size);
+
+/*! \fn fold_with_ensemble
+ * \brief fold_with_ensemble
+ * Fold function that also keeps the unpaired probabilities, centroid structure and base pair probabilities
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_with_ensemble(const model_context* context, const char* sequence, const float bpp_cutoff, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ fold_ensemble*& ensemble);
+
+/*! \fn fold_with_ensemble_view
+ * \brief fold_with_ensemble_view
+ * Fold a sequence given by its length, also keeping the ensemble data
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_with_ensemble_view(const model_context* context, const char* sequence, const size_t length, const float bpp_cutoff, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ fold_ensemble*& ensemble);
+
+/*! \fn fold_ensemble_free
+ * \brief fold_ensemble_free
+ * Function to free fold ensemble data memory
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC void fold_ensemble_free(fold_ensemble* ensemble);
+
+/*! \fn fold_with_options
+ * \brief fold_with_options
+ * Fold function with a configurable energy band, maximum structure count, probability cutoff and normalization
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_with_options(const model_context* context, const char* sequence, const fold_options& options, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ float& captured_probability);
+
+/*! \fn fold_with_options_view
+ * \brief fold_with_options_view
+ * Fold a sequence given by its length with bounded suboptimal enumeration
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_with_options_view(const model_context* context, const char* sequence, const size_t length, const fold_options& options, /*out*/ fold_output*& output, /*out*/ size_t& size, /*out*/ float& captured_probability);
+
+/*! \fn fold_stream
+ * \brief fold_stream
+ * Fold function streaming each suboptimal structure to a callback
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_stream(const model_context* context, const char* sequence, const fold_options& options, fold_callback callback, void* data, /*out*/ size_t& size);
+
+/*! \fn fold_sample
+ * \brief fold_sample
+ * Fold function drawing a fixed number of structures from the Boltzmann ensemble.
+ * In non-redundant mode, fewer than `samples` structures may be returned: structures
+ * are drawn with replacement and deduplicated, for a bounded number of draws.
+ * The draws of concurrent calls serialize on ViennaRNA's shared random number generator.
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_sample(const model_context* context, const char* sequence, const size_t samples, const bool non_redundant, /*out*/ fold_output*& output, /*out*/ size_t& size);
+
+/*! \fn fold_into
+ * \brief fold_into
+ * Fold function writing structures, probabilities and energies into caller-provided columns
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_into(const model_context* context, const char* sequence, const size_t capacity, /*out*/ char* structures, /*out*/ float* probabilities, /*out*/ float* energies, /*out*/ size_t& size);
+
+/*! \fn fold_arena_create
+ * \brief fold_arena_create
+ * Fold function writing structures, probabilities and energies as columns into a single allocation
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_arena_create(const model_context* context, const char* sequence, /*out*/ fold_arena*& arena);
+
+/*! \fn fold_arena_free
+ * \brief fold_arena_free
+ * Function to free fold arena memory
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC void fold_arena_free(fold_arena* arena);
+
+/*! \fn fold_batch
+ * \brief fold_batch
+ * Fold function used to fold a batch of sequences in parallel with ViennaRNA
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS fold_batch(const model_context* context, const char** sequences, const size_t count, const int thread_count, /*out*/ fold_output** outputs, /*out*/ size_t* sizes, /*out*/ R_STATUS* statuses);
+
+/*! \fn fold_batch_free
+ * \brief fold_batch_free
+ * Function to free batched fold structure memory
+ * @file fold.cpp
+ */
+extern "C" DLL_PUBLIC void fold_batch_free(fold_output** outputs, size_t* sizes, const size_t count);
+
+/*! \fn fold_pool_configure
+ * \brief fold_pool_configure
+ * Bound (or disable with 0, the default) the fold compounds each thread keeps for reuse
+ * @file fold_pool.cpp
+ */
+extern "C" DLL_PUBLIC void fold_pool_configure(const size_t max_bytes);
+
+/*! \fn fold_pool_clear
+ * \brief fold_pool_clear
+ * Drop the pooled fold compounds of every thread and reset the counters
+ * @file fold_pool.cpp
+ */
+extern "C" DLL_PUBLIC void fold_pool_clear();
+
+/*! \fn fold_pool_stats
+ * \brief fold_pool_stats
+ * Hit and miss counters and estimated size of the pooled fold compounds
+ * @file fold_pool.cpp
+ */
+extern "C" DLL_PUBLIC void fold_pool_stats(/*out*/ uint64_t& hits, /*out*/ uint64_t& misses, /*out*/ size_t& bytes);
+
 /*! \fn mfe_default_fold
  * \brief mfe_deafult_fold
  * Fold function used to fold sequence w/o constraints with ViennaRNA
@@ -76,6 +638,13 @@ extern "C" DLL_PUBLIC void fold_output_free(fold_output* output, size_t size);
  */
 extern "C" DLL_PUBLIC R_STATUS mfe_default_fold(const char* sequence, /*out*/ char*& structure);
 
+/*! \fn mfe_default_fold_view
+ * \brief mfe_default_fold_view
+ * Fold a sequence given by its length w/o constraints with ViennaRNA
+ * @file mfe_default_fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS mfe_default_fold_view(const char* sequence, const size_t length, /*out*/ char*& structure);
+
 /*! \fn fold_output_free
  * \brief fold_output_free
  * Function to free fold structure memory
@@ -83,6 +652,69 @@ extern "C" DLL_PUBLIC R_STATUS mfe_default_fold(const char* sequence, /*out*/ ch
  */
 extern "C" DLL_PUBLIC void mfe_default_fold_free(char* output);
 
+/*! \fn mfe_fold_with_context
+ * \brief mfe_fold_with_context
+ * Fold function used to fold sequence w/o constraints with ViennaRNA, in a model context
+ * @file mfe_default_fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS mfe_fold_with_context(const model_context* context, const char* sequence, /*out*/ char*& structure);
+
+/*! \fn mfe_fold_validated
+ * \brief mfe_fold_validated
+ * MFE fold of a validated sequence
+ * @file mfe_default_fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS mfe_fold_validated(const model_context* context, const validated_sequence* sequence, /*out*/ char*& structure);
+
+/*! \fn local_fold
+ * \brief local_fold
+ * Fold function used to fold long RNA with a sliding window with ViennaRNA
+ * @file local_fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS local_fold(const model_context* context, const char* sequence, const int window_size, const int max_bp_span, /*out*/ char*& structure);
+
+/*! \fn local_fold_view
+ * \brief local_fold_view
+ * Fold long RNA given by its length with a sliding window with ViennaRNA
+ * @file local_fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS local_fold_view(const model_context* context, const char* sequence, const size_t length, const int window_size, const int max_bp_span, /*out*/ char*& structure);
+
+/*! \fn local_fold_stream
+ * \brief local_fold_stream
+ * Fold function streaming the local structures of a sliding window fold to a callback
+ * @file local_fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS local_fold_stream(const model_context* context, const char* sequence, const int window_size, const int max_bp_span, local_fold_callback callback, void* data, /*out*/ size_t& size);
+
+/*! \fn local_unpaired_stream
+ * \brief local_unpaired_stream
+ * Function streaming the unpaired probabilities of each position of a sliding window fold to a callback
+ * @file local_fold.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS local_unpaired_stream(const model_context* context, const char* sequence, const int window_size, const int max_bp_span, const int max_length, unpaired_callback callback, void* data);
+
+/*! \fn model_context_create
+ * \brief model_context_create
+ * Function to set the folding and annealing conditions of a job once
+ * @file model_context.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS model_context_create(const float temperature, const int dangles, const int max_bp_span, const float na_concentration, const float probe_concentration, /*out*/ model_context*& handle);
+
+/*! \fn model_context_free
+ * \brief model_context_free
+ * Function to free model context memory
+ * @file model_context.cpp
+ */
+extern "C" DLL_PUBLIC void model_context_free(model_context* handle);
+
+/*! \fn model_context_set_structure_score_mode
+ * \brief model_context_set_structure_score_mode
+ * Select the method used by the structure scores of a model context
+ * @file model_context.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS model_context_set_structure_score_mode(model_context* handle, const STRUCTURE_SCORE_MODE mode);
+
 /*! \fn structure
  * \brief structure
  * Comparison of secondary structures
@@ -90,4 +722,88 @@ extern "C" DLL_PUBLIC void mfe_default_fold_free(char* output);
  */
 extern "C" DLL_PUBLIC R_STATUS structure(const char* candidate, const char* ideal, /*out*/ float& distance);
 
+/*! \fn structure_view
+ * \brief structure_view
+ * Comparison of secondary structures given by their length
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_view(const char* candidate, const size_t candidate_length, const char* ideal, const size_t ideal_length, /*out*/ float& distance);
+
+/*! \fn structure_ideal_create
+ * \brief structure_ideal_create
+ * Parse an ideal secondary structure once for repeated comparisons
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_ideal_create(const char* ideal, /*out*/ structure_ideal*& handle);
+
+/*! \fn structure_ideal_compare
+ * \brief structure_ideal_compare
+ * Comparison of a secondary structure to a parsed ideal structure
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_ideal_compare(const structure_ideal* handle, const char* candidate, /*out*/ float& distance);
+
+/*! \fn structure_ideal_compare_validated
+ * \brief structure_ideal_compare_validated
+ * Distance between a validated structure and a parsed ideal structure
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_ideal_compare_validated(const structure_ideal* handle, const validated_structure* candidate, /*out*/ float& distance);
+
+/*! \fn structure_ideal_free
+ * \brief structure_ideal_free
+ * Function to free parsed ideal structure memory
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC void structure_ideal_free(structure_ideal* handle);
+
+/*! \fn structure_ensemble_defect
+ * \brief structure_ensemble_defect
+ * Ensemble defect of a design to its ideal structure, without suboptimal enumeration
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_ensemble_defect(const model_context* context, const char* sequence, const char* ideal, /*out*/ float& defect);
+
+/*! \fn structure_ensemble_defect_view
+ * \brief structure_ensemble_defect_view
+ * Ensemble defect of a design and ideal structure given by their length
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_ensemble_defect_view(const model_context* context, const char* sequence, const size_t sequence_length, const char* ideal, const size_t ideal_length, /*out*/ float& defect);
+
+/*! \fn structure_score
+ * \brief structure_score
+ * Fold a design and compare each suboptimal structure to the ideal structure
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_score(const char* sequence, const char* ideal, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability);
+
+/*! \fn structure_score_view
+ * \brief structure_score_view
+ * Structure score of a design and ideal structure given by their length
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_score_view(const model_context* context, const char* sequence, const size_t sequence_length, const char* ideal, const size_t ideal_length, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability);
+
+/*! \fn structure_score_with_context
+ * \brief structure_score_with_context
+ * Structure score of a design, folded in a model context
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_score_with_context(const model_context* context, const char* sequence, const char* ideal, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability);
+
+/*! \fn structure_score_validated
+ * \brief structure_score_validated
+ * Structure score of a validated design against a parsed ideal structure
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_score_validated(const model_context* context, const validated_sequence* sequence, const structure_ideal* ideal, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability);
+
+/*! \fn structure_score_batch
+ * \brief structure_score_batch
+ * Structure score of a batch of designs, computed in parallel
+ * @file structure.cpp
+ */
+extern "C" DLL_PUBLIC R_STATUS structure_score_batch(const model_context* context, const char** sequences, const char** ideals, const size_t count, const int thread_count, /*out*/ float* weighted_distances, /*out*/ float* max_distances, /*out*/ float* probabilities, /*out*/ R_STATUS* statuses);
+
 }
@@ -0,0 +1,385 @@
+#include "dll.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include <ViennaRNA/data_structures.h>
+#include <ViennaRNA/Lfold.h>
+#include <ViennaRNA/LPfold.h>
+
+#include "functions.h"
+#include "fold.h"
+#include "model_context.h"
+
+extern "C" {
+    /**
+     *  @brief  Retrieve a vrna_fold_compound_t data structure for single sequences and hybridizing sequences
+     *
+     *  @param    sequence    A single sequence, or two concatenated sequences seperated by an '&' character
+     *  @param    md_p        An optional set of model details
+     *  @param    options     The options for DP matrices memory allocation
+     *  @return               A prefilled vrna_fold_compound_t that can be readily used for computations
+     */
+    vrna_fold_compound_t* vrna_fold_compound(const char* sequence, vrna_md_t* md_p, unsigned int options);
+
+    /**
+     *  @brief Apply default model details to a provided #vrna_md_t data structure
+     *
+     *  @param md A pointer to the data structure that is about to be initialized
+     */
+    void vrna_md_set_default(vrna_md_t* md);
+}
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*! \struct local_structure
+ * \brief Locally optimal structure of a window
+ */
+struct local_structure {
+    size_t start; //!< 0-based start of the structure
+    float energy; //!< Free energy (kcal/mol)
+    std::string structure; //!< Dot-bracket structure from start
+};
+
+/*! \struct local_stream
+ * \brief Consumer of the local structures of a sliding-window fold
+ */
+struct local_stream {
+    local_fold_callback callback; //!< Consumer of the structures
+    void* data; //!< Caller data passed to the callback
+    bool stopped; //!< Set once the callback asked to stop receiving structures
+    size_t size; //!< Number of structures passed to the callback
+};
+
+/*! \struct unpaired_stream
+ * \brief Consumer of the unpaired probabilities of a sliding-window fold
+ */
+struct unpaired_stream {
+    unpaired_callback callback; //!< Consumer of the probabilities
+    void* data; //!< Caller data passed to the callback
+    bool stopped; //!< Set once the callback asked to stop receiving probabilities
+    std::vector<float> probabilities; //!< Probabilities of the current position
+};
+
+/*!
+ * \brief Validate the window of a local fold and make the fold compound
+ * The window is shortened to the sequence, and a base pair span of 0 is the window size.
+ * The other model details (temperature, dangles) are the context's. Its
+ * precomputed parameters are not substituted, as ViennaRNA reads the window
+ * and span of a local fold from the model details held with them.
+ *
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Validated sequence
+ * \param window_size Size of the sliding window
+ * \param max_bp_span Maximum span of a base pair (0 for the window size)
+ * \param vc Out variable for the fold compound, to be freed by the caller on success
+ * \return Status Code
+ */
+static R_STATUS prepare_window(const model_context* context, const char* sequence, const int window_size, const int max_bp_span, /*out*/ vrna_fold_compound_t*& vc)
+{
+    const int length = static_cast<int>(strlen(sequence));
+    const int window = std::min(window_size, length);
+    const int span = max_bp_span == 0 ? window : max_bp_span;
+
+    if (window < MIN_BP_SPAN || span < MIN_BP_SPAN || span > window) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    vrna_md_t md;
+    if (context != nullptr) {
+        md = context->md;
+    } else {
+        vrna_md_set_default(&md);
+    }
+    md.window_size = window;
+    md.max_bp_span = span;
+
+    // windowed matrices hold O(n * W) entries, and are not pooled
+    vc = vrna_fold_compound(sequence, &md, VRNA_OPTION_DEFAULT | VRNA_OPTION_WINDOW);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Pass a local structure from ViennaRNA to the caller
+ *
+ * \param start 1-based start of the structure
+ * \param end 1-based end of the structure
+ * \param structure Dot-bracket structure from start to end
+ * \param energy Free energy (kcal/mol)
+ * \param data Stream
+ */
+static void stream_local(int start, int end, const char* structure, float energy, void* data)
+{
+    local_stream& stream = *static_cast<local_stream*>(data);
+
+    // ViennaRNA 2.4 cannot be interrupted, so later structures are only ignored
+    if (stream.stopped || structure == nullptr) {
+        return;
+    }
+
+    ++stream.size;
+    if (stream.callback(start - 1, end - start + 1, structure, energy, stream.data) == 0) {
+        stream.stopped = true;
+    }
+}
+
+/*!
+ * \brief Collect a local structure from ViennaRNA
+ *
+ * \param start 1-based start of the structure
+ * \param end 1-based end of the structure
+ * \param structure Dot-bracket structure from start to end
+ * \param energy Free energy (kcal/mol)
+ * \param data Vector of local structures
+ */
+static void collect_local(int start, int end, const char* structure, float energy, void* data)
+{
+    if (structure != nullptr) {
+        static_cast<std::vector<local_structure>*>(data)->push_back({ static_cast<size_t>(start - 1), energy, std::string(structure, end - start + 1) });
+    }
+}
+
+/*!
+ * \brief Pass the unpaired probabilities of a position from ViennaRNA to the caller
+ *
+ * \param pr Probabilities, pr[u] for the stretch of length u ending at i (1-based)
+ * \param pr_size Number of stretch lengths
+ * \param i 1-based position
+ * \param max Length of the sequence
+ * \param type Kind of probabilities
+ * \param data Stream
+ */
+static void stream_unpaired(FLT_OR_DBL* pr, int pr_size, int i, int max, unsigned int type, void* data)
+{
+    (void)max;
+    unpaired_stream& stream = *static_cast<unpaired_stream*>(data);
+
+    if (stream.stopped || !(type & VRNA_PROBS_WINDOW_UP)) {
+        return;
+    }
+
+    stream.probabilities.resize(pr_size);
+    for (int u = 1; u <= pr_size; ++u) {
+        stream.probabilities[u - 1] = static_cast<float>(pr[u]);
+    }
+
+    if (stream.callback(i - 1, stream.probabilities.data(), stream.probabilities.size(), stream.data) == 0) {
+        stream.stopped = true;
+    }
+}
+
+/*!
+ * \brief Streamed sliding-window fold
+ * Used to fold long RNA in O(n * W) memory: only base pairs within
+ * `max_bp_span` are considered, and each locally optimal structure is passed
+ * to the callback as soon as ViennaRNA finds it (from the 3' end).
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | callback is null
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | window (shortened to the sequence) or base pair span is below 4, or the span exceeds the window
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence RNA sequence
+ * \param window_size Size of the sliding window
+ * \param max_bp_span Maximum span of a base pair (0 for the window size)
+ * \param callback Consumer of each local structure, returning 0 to stop receiving them
+ * \param data Caller data passed to the callback
+ * \param size Out variable for the number of structures passed to the callback
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS local_fold_stream(const model_context* context, const char* sequence, const int window_size, const int max_bp_span, local_fold_callback callback, void* data, /*out*/ size_t& size)
+{
+    if (callback == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    R_STATUS status = validate_sequence(sequence);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    vrna_fold_compound_t* vc = nullptr;
+    status = prepare_window(context, sequence, window_size, max_bp_span, vc);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    local_stream stream{ callback, data, false, 0 };
+    (void)vrna_mfe_window_cb(vc, &stream_local, &stream); // MFE value not used, only the structures
+    vrna_fold_compound_free(vc);
+
+    size = stream.size;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Sliding-window MFE fold of a validated sequence
+ * Same as `local_fold`, on a sequence already checked to hold only A, C, G and U.
+ *
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Validated RNA sequence
+ * \param length Length of the sequence
+ * \param window_size Size of the sliding window
+ * \param max_bp_span Maximum span of a base pair (0 for the window size)
+ * \param structure Out string containing the structure of the input sequence
+ * \return Status Code
+ */
+static R_STATUS local_fold_validated(const model_context* context, const char* sequence, size_t length, const int window_size, const int max_bp_span, /*out*/ char*& structure)
+{
+    vrna_fold_compound_t* vc = nullptr;
+    R_STATUS status = prepare_window(context, sequence, window_size, max_bp_span, vc);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    std::vector<local_structure> structures;
+    (void)vrna_mfe_window_cb(vc, &collect_local, &structures);
+    vrna_fold_compound_free(vc);
+
+    std::stable_sort(structures.begin(), structures.end(), [](const local_structure& a, const local_structure& b) {
+        return a.energy < b.energy;
+    });
+
+    structure = new char[length + 1];
+    memset(structure, '.', length);
+    structure[length] = '\0';
+
+    for (const local_structure& local : structures) {
+        const size_t end = local.start + local.structure.size();
+        if (end > length || std::any_of(structure + local.start, structure + end, [](char c) { return c != '.'; })) {
+            continue;
+        }
+
+        // kept only where every position is still unpaired, so structures may share unpaired flanks
+        std::copy(local.structure.begin(), local.structure.end(), structure + local.start);
+    }
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Sliding-window MFE fold
+ * Used in place of `mfe_default_fold` for long RNA, in O(n * W) memory. The
+ * local structures are combined from the most stable, each one kept only if
+ * it does not overlap a more stable one, into a structure of the whole RNA.
+ *
+ * Understanding return values:
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | window (shortened to the sequence) or base pair span is below 4, or the span exceeds the window
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence RNA sequence
+ * \param window_size Size of the sliding window
+ * \param max_bp_span Maximum span of a base pair (0 for the window size)
+ * \param structure Out string containing the structure of the input sequence, released with `mfe_default_fold_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS local_fold(const model_context* context, const char* sequence, const int window_size, const int max_bp_span, /*out*/ char*& structure)
+{
+    size_t length;
+    R_STATUS status = validate_sequence_position(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    return local_fold_validated(context, sequence, length, window_size, max_bp_span, structure);
+}
+
+/*!
+ * \brief Sliding-window MFE fold of a view
+ * Same as `local_fold`, on a sequence given by its length, which need not be
+ * terminated (for example a range of the RNA input). ViennaRNA reads
+ * terminated strings, so the view is copied once into a buffer reused by the thread.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null
+ * - R_EMPTY_PARAMETER | length is 0
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | window (shortened to the sequence) or base pair span is below 4, or the span exceeds the window
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence Start of the RNA sequence
+ * \param length Length of the sequence
+ * \param window_size Size of the sliding window
+ * \param max_bp_span Maximum span of a base pair (0 for the window size)
+ * \param structure Out string containing the structure of the input sequence, released with `mfe_default_fold_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS local_fold_view(const model_context* context, const char* sequence, const size_t length, const int window_size, const int max_bp_span, /*out*/ char*& structure)
+{
+    R_STATUS status = validate_sequence_view(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    thread_local std::string terminated;
+    terminated.assign(sequence, length);
+
+    return local_fold_validated(context, terminated.c_str(), length, window_size, max_bp_span, structure);
+}
+
+/*!
+ * \brief Streamed sliding-window unpaired probabilities
+ * Used to get the accessibility of long RNA in O(n * W) memory: for each
+ * position i, in order, the callback receives probabilities[u - 1], the
+ * probability that the stretch of length u ending at i is unpaired, for u up
+ * to `max_length` (fewer near the 5' end), averaged over every window holding the stretch.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | callback is null
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | window or base pair span is invalid (see `local_fold_stream`), or max_length is not within [1, window]
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param sequence RNA sequence
+ * \param window_size Size of the sliding window
+ * \param max_bp_span Maximum span of a base pair (0 for the window size)
+ * \param max_length Longest unpaired stretch
+ * \param callback Consumer of the probabilities of each position, returning 0 to stop receiving them
+ * \param data Caller data passed to the callback
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS local_unpaired_stream(const model_context* context, const char* sequence, const int window_size, const int max_bp_span, const int max_length, unpaired_callback callback, void* data)
+{
+    if (callback == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    R_STATUS status = validate_sequence(sequence);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    vrna_fold_compound_t* vc = nullptr;
+    status = prepare_window(context, sequence, window_size, max_bp_span, vc);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (max_length < 1 || max_length > std::min(window_size, static_cast<int>(strlen(sequence)))) {
+        vrna_fold_compound_free(vc);
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    unpaired_stream stream{ callback, data, false, {} };
+    const int result = vrna_probs_window(vc, max_length, VRNA_PROBS_WINDOW_UP, &stream_unpaired, &stream);
+    vrna_fold_compound_free(vc);
+
+    if (result == 0) {
+        return R_SYSTEM_ERROR::R_VIENNA_RNA_ERROR;
+    }
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+}
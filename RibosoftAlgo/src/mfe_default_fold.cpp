@@ -3,11 +3,15 @@
 #include <cstdlib>
 #include <cstring>
 #include <cmath>
+#include <string>
 
 #include <ViennaRNA/data_structures.h>
 #include <ViennaRNA/constraints.h>
 
 #include "functions.h"
+#include "fold_pool.h"
+#include "model_context.h"
+#include "validation.h"
 
 extern "C"
 {
@@ -84,6 +88,51 @@ extern "C"
 
 //! \namespace ribosoft
 namespace ribosoft {
+    /*!
+     * \brief MFE fold of a validated sequence in a model context
+     *
+     * \param sequence Validated sequence to fold, terminated
+     * \param length Length of the sequence
+     * \param context Model context, or nullptr for the default model
+     * \param structure Out string containing the structure of the input sequence
+     * \return Status Code
+     */
+    static R_STATUS mfe_fold_validated_sequence(const char* sequence, size_t length, const model_context* context, /*out*/ char*& structure)
+    {
+        const vrna_md_t* md = context_model_details(context);
+
+        // Default fold
+        structure = new char[length + 1];
+        vrna_fold_compound_t* defaultFoldCompound = acquire_fold_compound(sequence, md);
+        context_prepare_mfe(defaultFoldCompound, context);
+        (void)vrna_mfe(defaultFoldCompound, structure); // MFE value not used, just computing structure
+
+        structure[length] = '\0';
+
+        release_fold_compound(defaultFoldCompound, md);
+
+        return R_SUCCESS::R_STATUS_OK;
+    }
+
+    /*!
+     * \brief MFE fold in a model context
+     *
+     * \param sequence to fold
+     * \param context Model context, or nullptr for the default model
+     * \param structure Out string containing the structure of the input sequence
+     * \return Status Code
+     */
+    static R_STATUS mfe_fold(const char* sequence, const model_context* context, /*out*/ char*& structure)
+    {
+        size_t length;
+        R_STATUS status = validate_sequence_position(sequence, length);
+        if (status != R_SUCCESS::R_STATUS_OK) {
+            return status;
+        }
+
+        return mfe_fold_validated_sequence(sequence, length, context, structure);
+    }
+
     /*!
      * \brief MFE default fold.
      * Used to calculate the accessibility of the cutsite in the RNA sequence.
@@ -100,31 +149,87 @@ namespace ribosoft {
      */
     DLL_PUBLIC R_STATUS mfe_default_fold(const char* sequence, /*out*/ char*& structure)
     {
-        R_STATUS status = validate_sequence(sequence);
+        return mfe_fold(sequence, NULL, structure);
+    }
+
+    /*!
+     * \brief MFE default fold of a view
+     * Same as `mfe_default_fold`, on a sequence given by its length, which need
+     * not be terminated (for example a range of the RNA input). ViennaRNA reads
+     * terminated strings, so the view is copied once into a buffer reused by the thread.
+     *
+     * Understanding return values:
+     * - R_INVALID_PARAMETER | sequence is null
+     * - R_EMPTY_PARAMETER | length is 0
+     * - R_INVALID_NUCLEOTIDE | rna has an invalid nucleotide
+     * - R_VIENNA_RNA_ERROR | An error has occured with ViennaRNA. Contact us with details.
+     *
+     ***************************************************************************
+     * \param sequence Start of the sequence to fold
+     * \param length Length of the sequence
+     * \param structure Out string containing the structure of the input sequence, released with `mfe_default_fold_free`
+     * \return Status Code
+     */
+    DLL_PUBLIC R_STATUS mfe_default_fold_view(const char* sequence, const size_t length, /*out*/ char*& structure)
+    {
+        R_STATUS status = validate_sequence_view(sequence, length);
         if (status != R_SUCCESS::R_STATUS_OK) {
             return status;
         }
 
-        int length = strlen(sequence);
+        thread_local std::string terminated;
+        terminated.assign(sequence, length);
 
-        // Copy substring of sequence that will be folded
-        char* local_sequence = new char[length + 1];
-        strncpy(local_sequence, sequence, length);
-        local_sequence[length] = '\0';
-
-        // Default fold
-        structure = new char[length + 1];
-        vrna_fold_compound_t* defaultFoldCompound = vrna_fold_compound(local_sequence, NULL, VRNA_OPTION_DEFAULT);
-        (void)vrna_mfe(defaultFoldCompound, structure); // MFE value not used, just computing structure
+        return mfe_fold_validated_sequence(terminated.c_str(), length, NULL, structure);
+    }
 
-        structure[length] = '\0';
+    /*!
+     * \brief MFE fold in a model context
+     * Same as `mfe_default_fold`, with the model details of the context
+     * (temperature, dangles, maximum base pair span).
+     *
+     * Understanding return values:
+     * - R_INVALID_PARAMETER | context is null
+     * - R_INVALID_NUCLEOTIDE | rna has an invalid nucleotide
+     * - R_VIENNA_RNA_ERROR | An error has occured with ViennaRNA. Contact us with details.
+     *
+     ***************************************************************************
+     * \param context Model context of the job
+     * \param sequence to fold
+     * \param structure Out string containing the structure of the input sequence, released with `mfe_default_fold_free`
+     * \return Status Code
+     */
+    DLL_PUBLIC R_STATUS mfe_fold_with_context(const model_context* context, const char* sequence, /*out*/ char*& structure)
+    {
+        if (context == nullptr) {
+            return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+        }
 
-        // Free memory
-        delete[] local_sequence;
+        return mfe_fold(sequence, context, structure);
+    }
 
-        vrna_fold_compound_free(defaultFoldCompound);
+    /*!
+     * \brief MFE fold of a validated sequence
+     * Same as `mfe_default_fold` (or `mfe_fold_with_context`), without checking
+     * the sequence again.
+     *
+     * Understanding return values:
+     * - R_INVALID_PARAMETER | sequence is null
+     * - R_VIENNA_RNA_ERROR | An error has occured with ViennaRNA. Contact us with details.
+     *
+     ***************************************************************************
+     * \param context Model context of the job, or nullptr for the default model
+     * \param sequence Validated sequence to fold (see `validated_sequence_create`)
+     * \param structure Out string containing the structure of the input sequence, released with `mfe_default_fold_free`
+     * \return Status Code
+     */
+    DLL_PUBLIC R_STATUS mfe_fold_validated(const model_context* context, const validated_sequence* sequence, /*out*/ char*& structure)
+    {
+        if (sequence == nullptr) {
+            return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+        }
 
-        return R_SUCCESS::R_STATUS_OK;
+        return mfe_fold_validated_sequence(sequence->sequence.c_str(), sequence->sequence.size(), context, structure);
     }
 
     /*!
@@ -0,0 +1,225 @@
+#include "dll.h"
+
+#include <cstdlib>
+
+#include <ViennaRNA/data_structures.h>
+
+#include "functions.h"
+#include "fold.h"
+#include "model_context.h"
+#include "anneal.h"
+
+extern "C" {
+    /**
+     *  @brief Apply default model details to a provided #vrna_md_t data structure
+     *
+     *  @param md A pointer to the data structure that is about to be initialized
+     */
+    void vrna_md_set_default(vrna_md_t* md);
+
+    /**
+     *  @brief  Get a data structure containing prescaled free energy parameters
+     *
+     *  @param  md  A pointer to the model details to use for the scaling
+     *  @return     A data structure containing the energy parameters, freed with free()
+     */
+    vrna_param_t* vrna_params(vrna_md_t* md);
+
+    /**
+     *  @brief Update/Reset energy parameters data structure within a #vrna_fold_compound_t
+     *
+     *  The parameters are copied into the fold compound.
+     *
+     *  @param  vc          The fold compound data structure
+     *  @param  parameters  A pointer to the new energy parameters
+     */
+    void vrna_params_subst(vrna_fold_compound_t* vc, vrna_param_t* parameters);
+
+    /**
+     *  @brief  Get a data structure containing prescaled free energy parameters
+     *
+     *  @param  md  A pointer to the model details to use for the scaling
+     *  @return     A data structure containing the Boltzmann weights, freed with free()
+     */
+    vrna_exp_param_t* vrna_exp_params(vrna_md_t* md);
+
+    /**
+     *  @brief Update the energy parameters for subsequent partition function computations
+     *
+     *  The parameters are copied into the fold compound.
+     *
+     *  @param  vc    The fold compound data structure
+     *  @param  params A pointer to the new Boltzmann factors
+     */
+    void vrna_exp_params_subst(vrna_fold_compound_t* vc, vrna_exp_param_t* params);
+}
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+constexpr float MIN_TEMPERATURE = -273.15f; //!< Absolute zero (degrees centigrade), itself out of range
+constexpr float MAX_TEMPERATURE = 150.0f; //!< Highest temperature of the energy parameters (degrees centigrade)
+
+/*!
+ * \brief Model details of a context
+ *
+ * \param context Model context, or nullptr for the defaults
+ * \return Model details, or nullptr for the defaults
+ */
+const vrna_md_t* context_model_details(const model_context* context)
+{
+    return context != nullptr ? &context->md : nullptr;
+}
+
+/*!
+ * \brief Structure score method of a context
+ *
+ * \param context Model context, or nullptr for the defaults
+ * \return Method selected with `model_context_set_structure_score_mode`, or STRUCTURE_SCORE_SUBOPT for the defaults
+ */
+int context_structure_score_mode(const model_context* context)
+{
+    return context != nullptr ? context->structure_score_mode : STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_SUBOPT;
+}
+
+/*!
+ * \brief Precomputed energy parameters
+ * ViennaRNA copies the parameters instead of scaling every energy to the
+ * model temperature again. A fold compound already holding the context's
+ * parameters (a pooled one, see `fold_pool_configure`) keeps them.
+ *
+ * \param vc Fold compound created with the context's model details
+ * \param context Model context, or nullptr for the defaults
+ */
+void context_prepare_mfe(vrna_fold_compound_t* vc, const model_context* context)
+{
+    if (context != nullptr && (vc->params == nullptr || vc->params->id != context->params->id)) {
+        vrna_params_subst(vc, context->params);
+    }
+}
+
+/*!
+ * \brief Precomputed Boltzmann factors
+ * ViennaRNA copies the factors instead of scaling every parameter to the
+ * model temperature again.
+ *
+ * \param vc Fold compound created with the context's model details
+ * \param context Model context, or nullptr for the defaults
+ */
+void context_prepare_pf(vrna_fold_compound_t* vc, const model_context* context)
+{
+    if (context != nullptr) {
+        vrna_exp_params_subst(vc, context->exp_params);
+    }
+}
+
+/*!
+ * \brief Create model context
+ * Used to set the conditions of a job once: the folds of `fold_with_context`,
+ * `mfe_fold_with_context` and `structure_score_with_context` use its model
+ * details, with energy parameters and Boltzmann factors computed once, and
+ * `anneal_with_context` its concentrations and target temperature. Its
+ * structure scores compare suboptimal structures until
+ * `model_context_set_structure_score_mode`.
+ * ViennaRNA 2.4 has no salt correction, so the Na+ concentration only applies
+ * to melting temperatures.
+ *
+ * Understanding return values:
+ * - R_OUT_OF_RANGE | temperature is not within (-273.15, 150], or max_bp_span is neither -1 nor 4 or more
+ * - R_INVALID_PARAMETER | dangles is not 0, 1, 2 or 3
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************************
+ * \param temperature Target temperature (degrees centigrade)
+ * \param dangles Dangling end model of ViennaRNA (2 by default)
+ * \param max_bp_span Maximum span of a base pair (-1 for no maximum)
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param handle Out variable for the context, released with `model_context_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS model_context_create(const float temperature, const int dangles, const int max_bp_span, const float na_concentration, const float probe_concentration, /*out*/ model_context*& handle)
+{
+    handle = nullptr;
+
+    if (!(temperature > MIN_TEMPERATURE && temperature <= MAX_TEMPERATURE)) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    if (max_bp_span != -1 && max_bp_span < MIN_BP_SPAN) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    if (dangles < 0 || dangles > 3) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    R_STATUS status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    handle = new model_context;
+    vrna_md_set_default(&handle->md);
+    handle->md.temperature = temperature;
+    handle->md.dangles = dangles;
+    handle->md.max_bp_span = max_bp_span;
+    handle->params = vrna_params(&handle->md);
+    handle->exp_params = vrna_exp_params(&handle->md);
+    handle->temperature = temperature;
+    handle->na_concentration = na_concentration;
+    handle->probe_concentration = probe_concentration;
+    handle->structure_score_mode = STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_SUBOPT;
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Select the structure score method of a model context
+ * Used to choose how the structure scores in this context (`structure_score_with_context`
+ * and `structure_score_batch`) compare the folds of a design to its ideal structure:
+ * the tree edit distance of every suboptimal structure weighted by its
+ * probability (default), the same with the probabilities normalized by the
+ * enumerated band instead of the partition function (as `FOLD_NORMALIZATION_SUBOPTIMAL`),
+ * or the ensemble defect from the base pair probabilities, which does not
+ * enumerate suboptimals. Other jobs, with their own context, are not affected.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | handle is null, or mode is not a STRUCTURE_SCORE_MODE
+ *
+ ***************************************************************************************
+ * \param handle Model context of the job
+ * \param mode Structure score method
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS model_context_set_structure_score_mode(model_context* handle, const STRUCTURE_SCORE_MODE mode)
+{
+    if (handle == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (mode != STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_SUBOPT && mode != STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_ENSEMBLE_DEFECT &&
+        mode != STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_SUBOPT_BAND) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    handle->structure_score_mode = mode;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from model context
+ *
+ ***************************************************************************************
+ * @param handle Model context to be freed
+ */
+DLL_PUBLIC void model_context_free(model_context* handle)
+{
+    if (handle) {
+        free(handle->params);
+        free(handle->exp_params);
+        delete handle;
+    }
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <ViennaRNA/data_structures.h>
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*! \struct model_context
+ * \brief Folding and annealing conditions of a job, with its energy parameters
+ * and their Boltzmann factors computed once
+ */
+struct model_context {
+    vrna_md_t md; //!< Model details (temperature, dangles, maximum base pair span)
+    vrna_param_t* params; //!< Energy parameters at the model temperature
+    vrna_exp_param_t* exp_params; //!< Boltzmann factors at the model temperature
+    float temperature; //!< Target temperature (degrees centigrade)
+    float na_concentration; //!< Sodium (Na+) concentration (in moles)
+    float probe_concentration; //!< Nucleic acid concentration in excess (in moles)
+    int structure_score_mode; //!< Method of the structure scores (see STRUCTURE_SCORE_MODE)
+};
+
+/*! \fn context_model_details
+ * \brief Model details of a context, or nullptr for the defaults
+ * @file model_context.cpp
+ */
+const vrna_md_t* context_model_details(const model_context* context);
+
+/*! \fn context_structure_score_mode
+ * \brief Structure score method of a context, or the suboptimal score for the defaults
+ * @file model_context.cpp
+ */
+int context_structure_score_mode(const model_context* context);
+
+/*! \fn context_prepare_mfe
+ * \brief Give a fold compound the precomputed energy parameters of a context before `vrna_mfe` or `vrna_subopt`
+ * @file model_context.cpp
+ */
+void context_prepare_mfe(vrna_fold_compound_t* vc, const model_context* context);
+
+/*! \fn context_prepare_pf
+ * \brief Give a fold compound the precomputed Boltzmann factors of a context before `vrna_pf`
+ * @file model_context.cpp
+ */
+void context_prepare_pf(vrna_fold_compound_t* vc, const model_context* context);
+
+}
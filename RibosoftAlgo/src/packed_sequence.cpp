@@ -0,0 +1,266 @@
+#include "dll.h"
+
+#include <array>
+#include <bit>
+#include <cstring>
+#include <algorithm>
+#include <string>
+
+#include "functions.h"
+#include "packed_sequence.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*!
+ * \brief 2-bit code of every character; only A, C, G and U are looked up
+ */
+constexpr std::array<std::uint8_t, 256> NUCLEOTIDE_CODES = [] {
+    std::array<std::uint8_t, 256> codes{};
+    codes['A'] = 0;
+    codes['C'] = 1;
+    codes['G'] = 2;
+    codes['U'] = 3;
+    return codes;
+}();
+
+/*!
+ * \brief Pack 8 validated nucleotides
+ * The 2-bit code of A (0x41), C (0x43), G (0x47) and U (0x55) is made of bits
+ * 1 and 2 of the character, so the 8 characters are coded at once in a
+ * register, then their codes are gathered into 16 bits.
+ *
+ * \param sequence Start of 8 nucleotides, holding only A, C, G and U
+ * \return Codes of the nucleotides, the first one most significant
+ */
+static inline std::uint64_t pack_eight(const char* sequence)
+{
+    std::uint64_t characters;
+    std::memcpy(&characters, sequence, sizeof(characters));
+    if constexpr (std::endian::native == std::endian::little) {
+        // first character in the high byte
+        characters = std::byteswap(characters);
+    }
+
+    const std::uint64_t bit1 = (characters >> 1) & 0x0101010101010101ull;
+    const std::uint64_t bit2 = (characters >> 2) & 0x0101010101010101ull;
+    std::uint64_t codes = (bit2 << 1) | (bit1 ^ bit2);
+
+    codes = (codes | (codes >> 6)) & 0x000F000F000F000Full;
+    codes = (codes | (codes >> 12)) & 0x000000FF000000FFull;
+    return (codes | (codes >> 24)) & 0xFFFFull;
+}
+
+/*!
+ * \brief Pack a validated sequence
+ *
+ * \param sequence Start of the sequence, holding only A, C, G and U
+ * \param length Length of the sequence
+ * \param packed Out variable for the packed sequence
+ */
+static void pack_validated(const char* sequence, size_t length, /*out*/ packed_sequence& packed)
+{
+    packed.length = length;
+    packed.words.assign((length + PACKED_WORD_NUCLEOTIDES - 1) / PACKED_WORD_NUCLEOTIDES + 1, 0);
+
+    for (size_t word = 0, start = 0; start < length; ++word, start += PACKED_WORD_NUCLEOTIDES) {
+        const size_t end = std::min(length, start + PACKED_WORD_NUCLEOTIDES);
+
+        std::uint64_t bits = 0;
+        size_t i = start;
+        for (; i + 8 <= end; i += 8) {
+            bits = (bits << 16) | pack_eight(sequence + i);
+        }
+        for (; i < end; ++i) {
+            bits = (bits << 2) | NUCLEOTIDE_CODES[static_cast<unsigned char>(sequence[i])];
+        }
+
+        // the first nucleotide goes in the high bits, also in the last (partial) word
+        packed.words[word] = bits << (2 * (start + PACKED_WORD_NUCLEOTIDES - end));
+    }
+}
+
+/*!
+ * \brief Pack a sequence
+ * Validates the sequence with the vectorized scan of `validate_sequence_view`,
+ * then packs it without checking the characters again.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null
+ * - R_EMPTY_PARAMETER | length is 0
+ * - R_INVALID_NUCLEOTIDE | Invalid nucleotide found in sequence
+ *
+ * \param sequence Start of the sequence, not necessarily terminated
+ * \param length Length of the sequence
+ * \param packed Out variable for the packed sequence
+ * \return Status Code
+ */
+R_STATUS pack_sequence(const char* sequence, size_t length, /*out*/ packed_sequence& packed)
+{
+    R_STATUS status = validate_sequence_view(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    pack_validated(sequence, length, packed);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Pack a terminated sequence
+ * The vectorized scan finds the length and validates the sequence at once.
+ *
+ * \param sequence Sequence
+ * \param packed Out variable for the packed sequence
+ * \return Status Code
+ */
+R_STATUS pack_sequence(const char* sequence, /*out*/ packed_sequence& packed)
+{
+    if (sequence == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    size_t length;
+    R_STATUS status = validate_sequence_position(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    pack_validated(sequence, length, packed);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Unpack nucleotides of a packed sequence
+ *
+ * \param packed Packed sequence
+ * \param start Start of the nucleotides
+ * \param length Number of nucleotides, with [start, start + length) in bounds
+ * \param sequence Out buffer of at least `length` characters
+ */
+void unpack_sequence(const packed_sequence& packed, size_t start, size_t length, /*out*/ char* sequence)
+{
+    for (size_t i = 0; i < length; i += PACKED_WORD_NUCLEOTIDES) {
+        const size_t span = std::min(PACKED_WORD_NUCLEOTIDES, length - i);
+        const std::uint64_t window = packed_window(packed, start + i, span);
+
+        for (size_t j = 0; j < span; ++j) {
+            sequence[i + j] = "ACGU"[window_nucleotide(window, span, j)];
+        }
+    }
+}
+
+/*!
+ * \brief Unpack a whole packed sequence
+ * Used where ViennaRNA needs the characters of a sequence held packed.
+ *
+ * \param packed Packed sequence
+ * \param sequence Out string of the nucleotides, resized to the length of the sequence
+ */
+void unpack_sequence(const packed_sequence& packed, /*out*/ std::string& sequence)
+{
+    sequence.resize(packed.length);
+    unpack_sequence(packed, 0, packed.length, sequence.data());
+}
+
+/*!
+ * \brief Create packed sequence
+ * Used to validate a sequence and hold it with 2 bits per nucleotide, a
+ * quarter of the memory of the characters.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null
+ * - R_EMPTY_PARAMETER | sequence is empty
+ * - R_INVALID_NUCLEOTIDE | Invalid nucleotide found in sequence
+ *
+ ***************************************************************************************
+ * \param sequence Sequence to pack
+ * \param handle Out variable for the packed sequence, released with `packed_sequence_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS packed_sequence_create(const char* sequence, /*out*/ packed_sequence*& handle)
+{
+    handle = nullptr;
+
+    packed_sequence* packed = new packed_sequence;
+    R_STATUS status = pack_sequence(sequence, *packed);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        delete packed;
+        return status;
+    }
+
+    handle = packed;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Window of a packed sequence
+ * Reads up to 32 nucleotides into one integer, 2 bits each (A = 0, C = 1,
+ * G = 2, U = 3), the first nucleotide most significant.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | handle is null
+ * - R_OUT_OF_RANGE | length is not within [1, 32], or the window is not within the sequence
+ *
+ ***************************************************************************************
+ * \param handle Packed sequence
+ * \param start Start of the window
+ * \param length Length of the window
+ * \param window Out variable for the packed nucleotides
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS packed_sequence_window(const packed_sequence* handle, const size_t start, const size_t length, /*out*/ std::uint64_t& window)
+{
+    if (handle == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (length == 0 || length > PACKED_WORD_NUCLEOTIDES || start > handle->length || length > handle->length - start) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    window = packed_window(*handle, start, length);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Unpack a range of a packed sequence
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | handle or sequence is null
+ * - R_OUT_OF_RANGE | the range is not within the packed sequence
+ *
+ ***************************************************************************************
+ * \param handle Packed sequence
+ * \param start Start of the range
+ * \param length Length of the range
+ * \param sequence Out buffer of at least `length + 1` characters, terminated
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS packed_sequence_unpack(const packed_sequence* handle, const size_t start, const size_t length, /*out*/ char* sequence)
+{
+    if (handle == nullptr || sequence == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (start > handle->length || length > handle->length - start) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    unpack_sequence(*handle, start, length, sequence);
+    sequence[length] = '\0';
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from packed sequence
+ *
+ ***************************************************************************************
+ * @param handle Packed sequence to be freed
+ */
+DLL_PUBLIC void packed_sequence_free(packed_sequence* handle)
+{
+    delete handle;
+}
+
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "functions.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+constexpr size_t PACKED_WORD_NUCLEOTIDES = 32; //!< Nucleotides held by one 64-bit word
+
+/*! \struct packed_sequence
+ * \brief Validated sequence with 2 bits per nucleotide (A = 0, C = 1, G = 2, U = 3),
+ * 32 nucleotides per word with the first one in the high bits, so any window
+ * of up to 32 nucleotides is read into one register
+ */
+struct packed_sequence {
+    size_t length; //!< Number of nucleotides
+    std::vector<std::uint64_t> words; //!< Packed nucleotides, followed by a zero word so windows never read past the end
+};
+
+/*! \fn pack_sequence
+ * \brief Validate a view of a sequence with the vectorized scan, then pack it
+ * @file packed_sequence.cpp
+ */
+R_STATUS pack_sequence(const char* sequence, size_t length, /*out*/ packed_sequence& packed);
+
+/*! \fn pack_sequence
+ * \brief Validate a terminated sequence with the vectorized scan, then pack it
+ * @file packed_sequence.cpp
+ */
+R_STATUS pack_sequence(const char* sequence, /*out*/ packed_sequence& packed);
+
+/*! \fn unpack_sequence
+ * \brief Write the nucleotides [start, start + length) of a packed sequence as characters (not terminated)
+ * @file packed_sequence.cpp
+ */
+void unpack_sequence(const packed_sequence& packed, size_t start, size_t length, /*out*/ char* sequence);
+
+/*! \fn unpack_sequence
+ * \brief Write a whole packed sequence as characters into a string
+ * @file packed_sequence.cpp
+ */
+void unpack_sequence(const packed_sequence& packed, /*out*/ std::string& sequence);
+
+/*! \fn packed_window
+ * \brief Nucleotides [start, start + length) of a packed sequence in the low bits
+ * of a register, the first one most significant (length within [1, 32], in bounds)
+ */
+inline std::uint64_t packed_window(const packed_sequence& packed, size_t start, size_t length)
+{
+    const size_t word = start / PACKED_WORD_NUCLEOTIDES;
+    const unsigned shift = 2 * (start % PACKED_WORD_NUCLEOTIDES);
+
+    // the next word is shifted in two steps so that an aligned window (shift 0) stays defined
+    const std::uint64_t window = (packed.words[word] << shift) | ((packed.words[word + 1] >> 1) >> (63 - shift));
+    return window >> (64 - 2 * length);
+}
+
+/*! \fn window_nucleotide
+ * \brief Code of the nucleotide at an index of a window
+ */
+inline int window_nucleotide(std::uint64_t window, size_t length, size_t index)
+{
+    return static_cast<int>(window >> (2 * (length - 1 - index))) & 3;
+}
+
+}
@@ -0,0 +1,124 @@
+#include "dll.h"
+
+#include <cstring>
+
+#include "functions.h"
+#include "pairing_index.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*!
+ * \brief Create pairing index
+ * Used to index the paired positions of a folded RNA (for example the output
+ * of `mfe_default_fold`) once, to check whether any range of it is single
+ * stranded in constant time with `pairing_index_unpaired`.
+ *
+ * Understanding return values:
+ * - R_EMPTY_PARAMETER | folded structure is empty
+ * - R_INVALID_STRUCT_ELEMENT | Element in structure is invalid
+ *
+ ***************************************************************************************
+ * \param folded_structure Structure of the folded RNA
+ * \param handle Out variable for the index, released with `pairing_index_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS pairing_index_create(const char* folded_structure, /*out*/ pairing_index*& handle)
+{
+    return pairing_index_create_view(folded_structure, strlen(folded_structure), handle);
+}
+
+/*!
+ * \brief Create pairing index of a view
+ * Same as `pairing_index_create`, on a structure given by its length, which
+ * need not be terminated.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | folded structure is null
+ * - R_EMPTY_PARAMETER | length is 0
+ * - R_INVALID_STRUCT_ELEMENT | Element in structure is invalid
+ *
+ ***************************************************************************************
+ * \param folded_structure Start of the structure of the folded RNA
+ * \param length Length of the structure
+ * \param handle Out variable for the index, released with `pairing_index_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS pairing_index_create_view(const char* folded_structure, const size_t length, /*out*/ pairing_index*& handle)
+{
+    handle = nullptr;
+
+    if (folded_structure == nullptr && length != 0) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (length == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+    const size_t words = length / 64 + 1;
+    std::vector<std::uint64_t> paired(words, 0);
+
+    for (size_t i = 0; i < length; ++i) {
+        const char element = folded_structure[i];
+        if (element == '(' || element == ')') {
+            paired[i / 64] |= std::uint64_t{ 1 } << (i % 64);
+        } else if (element != '.') {
+            return R_APPLICATION_ERROR::R_INVALID_STRUCT_ELEMENT;
+        }
+    }
+
+    handle = new pairing_index;
+    handle->length = length;
+    handle->paired = std::move(paired);
+    handle->rank.resize(words);
+
+    std::uint32_t count = 0;
+    for (size_t w = 0; w < words; ++w) {
+        handle->rank[w] = count;
+        count += std::popcount(handle->paired[w]);
+    }
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Single-strandedness of a range of the folded RNA
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | index is null
+ * - R_OUT_OF_RANGE | the range is not within the folded RNA
+ *
+ ***************************************************************************************
+ * \param handle Pairing index
+ * \param start Start of the range
+ * \param length Length of the range
+ * \param unpaired Out variable, true if no position of the range is paired
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS pairing_index_unpaired(const pairing_index* handle, const size_t start, const size_t length, /*out*/ bool& unpaired)
+{
+    if (handle == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (start > handle->length || length > handle->length - start) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    unpaired = range_unpaired(*handle, start, length);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from pairing index
+ *
+ ***************************************************************************************
+ * @param handle Pairing index to be freed
+ */
+DLL_PUBLIC void pairing_index_free(pairing_index* handle)
+{
+    delete handle;
+}
+
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*! \struct pairing_index
+ * \brief Paired positions of a folded RNA as a bitmap with a prefix count per
+ * 64-bit word, so the number of paired positions in any range is found in
+ * constant time
+ */
+struct pairing_index {
+    size_t length; //!< Length of the folded structure
+    std::vector<std::uint64_t> paired; //!< Bit i is set if position i is paired
+    std::vector<std::uint32_t> rank; //!< rank[w] is the number of paired positions before word w
+};
+
+/*! \fn paired_before
+ * \brief Number of paired positions in [0, position)
+ */
+inline size_t paired_before(const pairing_index& index, size_t position)
+{
+    const size_t word = position / 64;
+    const size_t bit = position % 64;
+    size_t count = index.rank[word];
+    if (bit != 0) {
+        count += std::popcount(index.paired[word] & ((std::uint64_t{ 1 } << bit) - 1));
+    }
+
+    return count;
+}
+
+/*! \fn range_unpaired
+ * \brief Whether every position of [start, start + length) is unpaired (range must be in bounds)
+ */
+inline bool range_unpaired(const pairing_index& index, size_t start, size_t length)
+{
+    return paired_before(index, start + length) == paired_before(index, start);
+}
+
+}
@@ -2,26 +2,70 @@
 
 #include <cstdlib>
 #include <cstring>
-#include <mutex>
+#include <algorithm>
+#include <string>
+#include <vector>
 
-#include <ViennaRNA/RNAstruct.h>
-#include <ViennaRNA/treedist.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "functions.h"
+#include "tree_distance.h"
+#include "fold.h"
+#include "validation.h"
+#include "model_context.h"
 
 //! \namespace ribosoft
 namespace ribosoft {
 
-std::mutex tree_edit_distance_mutex; //!< Mutex used to lock access to ViennaRNA library function `tree_edit_distance`
+/*! \struct structure_ideal
+ * \brief Ideal secondary structure parsed once into a tree and a pair table
+ */
+struct structure_ideal {
+    structure_tree tree; //!< Tree of the ideal structure
+    std::vector<int> pairs; //!< Partner of each position in `(` `)` pairs, or -1
+    size_t length; //!< Length of the ideal structure
+};
+
+thread_local structure_tree candidate_tree; //!< Tree of the candidate being compared on the current thread
+thread_local std::vector<int> candidate_pairs; //!< Pair table of the candidate being validated on the current thread
+
+/*!
+ * \brief Tree edit distance between a (validated) structure and a prepared tree
+ *
+ * @param candidate Candidate secondary structure
+ * @param length Length of the candidate
+ * @param ideal_tree Tree of the ideal secondary structure
+ * @return Distance
+ */
+static float structure_distance(const char* candidate, size_t length, const structure_tree& ideal_tree)
+{
+    make_structure_tree(candidate, length, candidate_tree);
+    return structure_tree_distance(candidate_tree, ideal_tree);
+}
+
+/*!
+ * \brief Tree edit distance between the bond pairs of a structure and a prepared tree
+ *
+ * @param candidate Partner of each position in `(` `)` pairs of the candidate, or -1
+ * @param ideal_tree Tree of the ideal secondary structure
+ * @return Distance
+ */
+static float structure_distance(const std::vector<int>& candidate, const structure_tree& ideal_tree)
+{
+    make_structure_tree(candidate, candidate_tree);
+    return structure_tree_distance(candidate_tree, ideal_tree);
+}
 
 /*!
  * \brief Structure score
- * Used to calculate a comparison between two secondary structures, using ViennaRNA
+ * Used to calculate the tree edit distance between two secondary structures, as
+ * ViennaRNA's `tree_edit_distance` does on their full representation
  *
  * Understanding return values:
  * - R_BAD_PAIR_MATCH | Error in structure bonds
  * - R_STRUCT_LENGTH_DIFFER | candidate and ideal are different lengths
- * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details
  ***********************************************************************************
  *
  * @param candidate Candidate secondary structure
@@ -32,44 +76,608 @@ std::mutex tree_edit_distance_mutex; //!< Mutex used to lock access to ViennaRNA
 DLL_PUBLIC R_STATUS structure(const char* candidate, const char* ideal, /*out*/ float& distance)
 {
     // Validate candidate structure
-    R_STATUS status = validate_structure(candidate);
+    R_STATUS status = make_pair_table(candidate, candidate_pairs);
     if (status != R_SUCCESS::R_STATUS_OK) {
         return status;
     }
 
-    // Validate ideal structure
-    status = validate_structure(ideal);
+    // Validate and parse ideal structure
+    structure_ideal* handle = nullptr;
+    status = structure_ideal_create(ideal, handle);
     if (status != R_SUCCESS::R_STATUS_OK) {
         return status;
     }
 
     // Validate equal lengths
-    if (strlen(candidate) != strlen(ideal)) {
+    size_t length = candidate_pairs.size();
+    if (length != handle->length) {
+        structure_ideal_free(handle);
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    keep_bond_pairs(candidate, candidate_pairs);
+    distance = structure_distance(candidate_pairs, handle->tree);
+    structure_ideal_free(handle);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Validate an ideal secondary structure and parse it into a tree
+ *
+ * @param ideal Ideal secondary structure, not necessarily terminated
+ * @param length Length of the ideal structure
+ * @param handle Out variable for the parsed ideal structure, released with `structure_ideal_free`
+ * @return State Code
+ */
+static R_STATUS make_structure_ideal(const char* ideal, size_t length, /*out*/ structure_ideal*& handle)
+{
+    thread_local std::vector<int> pairs;
+    R_STATUS status = make_pair_table(ideal, length, pairs);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    // only `(` `)` pairs are in the tree, pseudoknot brackets count as unpaired
+    keep_bond_pairs(ideal, pairs);
+
+    handle = new structure_ideal;
+    handle->length = length;
+    handle->pairs = pairs;
+    make_structure_tree(handle->pairs, handle->tree);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Structure score of views
+ * Same as `structure`, on structures given by their length, which need not be
+ * terminated (for example ranges of longer strings). Nothing is copied.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | a structure is null
+ * - R_EMPTY_PARAMETER | a structure is empty
+ * - R_INVALID_STRUCT_ELEMENT | Element in a structure is invalid
+ * - R_BAD_PAIR_MATCH | Error in structure bonds
+ * - R_STRUCT_LENGTH_DIFFER | candidate and ideal are different lengths
+ ***********************************************************************************
+ *
+ * @param candidate Start of the candidate secondary structure
+ * @param candidate_length Length of the candidate
+ * @param ideal Start of the ideal secondary structure
+ * @param ideal_length Length of the ideal
+ * @param distance Out variable for structure score
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_view(const char* candidate, const size_t candidate_length, const char* ideal, const size_t ideal_length, /*out*/ float& distance)
+{
+    if ((candidate == nullptr && candidate_length != 0) || (ideal == nullptr && ideal_length != 0)) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    R_STATUS status = make_pair_table(candidate, candidate_length, candidate_pairs);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    structure_ideal* handle = nullptr;
+    status = make_structure_ideal(ideal, ideal_length, handle);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (candidate_length != ideal_length) {
+        structure_ideal_free(handle);
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    keep_bond_pairs(candidate, candidate_pairs);
+    distance = structure_distance(candidate_pairs, handle->tree);
+    structure_ideal_free(handle);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Create ideal structure
+ * Used to validate an ideal secondary structure and parse it into a tree once,
+ * so that many candidate structures can be compared against it.
+ *
+ * Understanding return values:
+ * - R_INVALID_STRUCT_ELEMENT | Element in ideal is invalid
+ * - R_BAD_PAIR_MATCH | Error in ideal structure bonds
+ ***********************************************************************************
+ *
+ * @param ideal Ideal secondary structure
+ * @param handle Out variable for the parsed ideal structure, released with `structure_ideal_free`
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_ideal_create(const char* ideal, /*out*/ structure_ideal*& handle)
+{
+    return make_structure_ideal(ideal, strlen(ideal), handle);
+}
+
+/*!
+ * \brief Compare to ideal structure
+ * Used to calculate the distance between a candidate secondary structure and a parsed
+ * ideal structure. Only the candidate is validated and converted to a tree.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | handle is null
+ * - R_INVALID_STRUCT_ELEMENT | Element in candidate is invalid
+ * - R_BAD_PAIR_MATCH | Error in candidate structure bonds
+ * - R_STRUCT_LENGTH_DIFFER | candidate and ideal are different lengths
+ ***********************************************************************************
+ *
+ * @param handle Parsed ideal structure
+ * @param candidate Candidate secondary structure
+ * @param distance Out variable for structure score
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_ideal_compare(const structure_ideal* handle, const char* candidate, /*out*/ float& distance)
+{
+    if (handle == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    R_STATUS status = make_pair_table(candidate, candidate_pairs);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    size_t length = candidate_pairs.size();
+    if (length != handle->length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    keep_bond_pairs(candidate, candidate_pairs);
+    distance = structure_distance(candidate_pairs, handle->tree);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Compare a validated structure to ideal structure
+ * Same as `structure_ideal_compare`, without checking the candidate again.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | handle or candidate is null
+ * - R_STRUCT_LENGTH_DIFFER | candidate and ideal are different lengths
+ ***********************************************************************************
+ *
+ * @param handle Parsed ideal structure
+ * @param candidate Validated candidate secondary structure (see `validated_structure_create`)
+ * @param distance Out variable for structure score
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_ideal_compare_validated(const structure_ideal* handle, const validated_structure* candidate, /*out*/ float& distance)
+{
+    if (handle == nullptr || candidate == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (candidate->pairs.size() != handle->length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    distance = structure_distance(candidate->pairs, handle->tree);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from ideal structure
+ * Used to free the memory from a parsed ideal structure
+ *
+ ***********************************************************************************
+ * @param handle Parsed ideal structure to be freed
+ */
+DLL_PUBLIC void structure_ideal_free(structure_ideal* handle)
+{
+    delete handle;
+}
+
+/*!
+ * \brief Ensemble defect of a design
+ * Used to compute the expected number of positions of a design that are not in
+ * their ideal state (paired with their ideal partner, or unpaired), over the
+ * whole Boltzmann ensemble. Computed from one partition function, in O(n^2)
+ * after folding, however many suboptimal structures there are. Pseudoknot
+ * brackets of the ideal structure count as unpaired, as in the tree edit distance.
+ *
+ * Understanding return values:
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_BAD_PAIR_MATCH | Error in ideal structure bonds
+ * - R_STRUCT_LENGTH_DIFFER | sequence and ideal are different lengths
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details
+ ***********************************************************************************
+ *
+ * @param context Model context of the job, or nullptr for the default model
+ * @param sequence Design sequence to fold
+ * @param ideal Ideal secondary structure
+ * @param defect Out variable for the ensemble defect (0 to the length of the sequence)
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_ensemble_defect(const model_context* context, const char* sequence, const char* ideal, /*out*/ float& defect)
+{
+    R_STATUS status = validate_sequence(sequence);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    structure_ideal* handle = nullptr;
+    status = structure_ideal_create(ideal, handle);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (strlen(sequence) != handle->length) {
+        structure_ideal_free(handle);
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    double result = 0.0;
+    status = fold_ensemble_defect(sequence, handle->length, handle->pairs, context, result);
+    structure_ideal_free(handle);
+
+    if (status == R_SUCCESS::R_STATUS_OK) {
+        defect = static_cast<float>(result);
+    }
+
+    return status;
+}
+
+/*!
+ * \brief Ensemble defect of a design given as views
+ * Same as `structure_ensemble_defect`, on a sequence and an ideal structure
+ * given by their length, which need not be terminated. The ideal structure is
+ * read in place; ViennaRNA reads terminated strings, so the sequence is copied
+ * once into a buffer reused by the thread.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence or ideal is null
+ * - R_EMPTY_PARAMETER | sequence or ideal is empty
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_BAD_PAIR_MATCH | Error in ideal structure bonds
+ * - R_STRUCT_LENGTH_DIFFER | sequence and ideal are different lengths
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details
+ ***********************************************************************************
+ *
+ * @param context Model context of the job, or nullptr for the default model
+ * @param sequence Start of the design sequence to fold
+ * @param sequence_length Length of the sequence
+ * @param ideal Start of the ideal secondary structure
+ * @param ideal_length Length of the ideal
+ * @param defect Out variable for the ensemble defect (0 to the length of the sequence)
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_ensemble_defect_view(const model_context* context, const char* sequence, const size_t sequence_length, const char* ideal, const size_t ideal_length, /*out*/ float& defect)
+{
+    R_STATUS status = validate_sequence_view(sequence, sequence_length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (ideal == nullptr && ideal_length != 0) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    structure_ideal* handle = nullptr;
+    status = make_structure_ideal(ideal, ideal_length, handle);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (sequence_length != handle->length) {
+        structure_ideal_free(handle);
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    thread_local std::string terminated;
+    terminated.assign(sequence, sequence_length);
+
+    double result = 0.0;
+    status = fold_ensemble_defect(terminated.c_str(), handle->length, handle->pairs, context, result);
+    structure_ideal_free(handle);
+
+    if (status == R_SUCCESS::R_STATUS_OK) {
+        defect = static_cast<float>(result);
+    }
+
+    return status;
+}
+
+/*!
+ * \brief Structure score of a validated design against a parsed ideal structure
+ *
+ * \param sequence Validated design sequence to fold, of the ideal's length
+ * \param ideal Parsed ideal structure
+ * \param context Model context, or nullptr for the default model
+ * \param weighted_distance Out variable for the sum of distances weighted by fold probability
+ * \param max_distance Out variable for the largest distance of any suboptimal structure
+ * \param probability Out variable for the sum of fold probabilities
+ * \return Status Code
+ */
+static R_STATUS score_against_ideal(const char* sequence, const structure_ideal& ideal, const model_context* context, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability)
+{
+    const int mode = context_structure_score_mode(context);
+    if (mode == STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_ENSEMBLE_DEFECT) {
+        double defect = 0.0;
+        R_STATUS status = fold_ensemble_defect(sequence, ideal.length, ideal.pairs, context, defect);
+        if (status == R_SUCCESS::R_STATUS_OK) {
+            // the whole ensemble is covered, and no structure can be further than every position
+            weighted_distance = static_cast<float>(defect);
+            max_distance = static_cast<float>(ideal.length);
+            probability = 1.0f;
+        }
+
+        return status;
+    }
+
+    fold_output* output = nullptr;
+    size_t size = 0;
+    const int normalization = mode == STRUCTURE_SCORE_MODE::STRUCTURE_SCORE_SUBOPT_BAND ? FOLD_NORMALIZATION::FOLD_NORMALIZATION_SUBOPTIMAL : FOLD_NORMALIZATION::FOLD_NORMALIZATION_PARTITION_FUNCTION;
+    R_STATUS status = fold_validated_sequence(sequence, ideal.length, output, size, nullptr, 0.0f, context, normalization);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    double weighted_sum = 0.0;
+    double probability_sum = 0.0;
+    float max = 0.0f;
+
+    for (size_t i = 0; i < size; ++i) {
+        // suboptimals from ViennaRNA are well-formed, only the ideal needed validation
+        float distance = structure_distance(output[i].structure, ideal.length, ideal.tree);
+        weighted_sum += distance * output[i].probability;
+        probability_sum += output[i].probability;
+        max = std::max(max, distance);
+    }
+
+    fold_output_free(output, size);
+
+    weighted_distance = static_cast<float>(weighted_sum);
+    max_distance = max;
+    probability = static_cast<float>(probability_sum);
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Structure score of a design, optionally in a model context
+ *
+ * \param sequence Design sequence to fold
+ * \param ideal Ideal secondary structure
+ * \param context Model context, or nullptr for the default model
+ * \param weighted_distance Out variable for the sum of distances weighted by fold probability
+ * \param max_distance Out variable for the largest distance of any suboptimal structure
+ * \param probability Out variable for the sum of fold probabilities
+ * \return Status Code
+ */
+static R_STATUS score_structure(const char* sequence, const char* ideal, const model_context* context, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability)
+{
+    size_t length;
+    R_STATUS status = validate_sequence_position(sequence, length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    structure_ideal* handle = nullptr;
+    status = structure_ideal_create(ideal, handle);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (length != handle->length) {
+        structure_ideal_free(handle);
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    status = score_against_ideal(sequence, *handle, context, weighted_distance, max_distance, probability);
+    structure_ideal_free(handle);
+
+    return status;
+}
+
+/*!
+ * \brief Structure score of a design
+ * Used to fold a design sequence and compare every suboptimal structure to the
+ * ideal structure in a single call. The ideal structure is parsed once with
+ * `structure_ideal_create`, and the distances are weighted by the probability of each fold.
+ * Normalization by the maximum distance of the job is left to the caller.
+ *
+ * Understanding return values:
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_BAD_PAIR_MATCH | Error in ideal structure bonds
+ * - R_STRUCT_LENGTH_DIFFER | sequence and ideal are different lengths
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details
+ ***********************************************************************************
+ *
+ * @param sequence Design sequence to fold
+ * @param ideal Ideal secondary structure
+ * @param weighted_distance Out variable for the sum of distances weighted by fold probability
+ * @param max_distance Out variable for the largest distance of any suboptimal structure
+ * @param probability Out variable for the sum of fold probabilities
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_score(const char* sequence, const char* ideal, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability)
+{
+    return score_structure(sequence, ideal, nullptr, weighted_distance, max_distance, probability);
+}
+
+/*!
+ * \brief Structure score of a design given as views
+ * Same as `structure_score` (or `structure_score_with_context`), on a sequence
+ * and an ideal structure given by their length, which need not be terminated. The ideal structure is read in
+ * place; ViennaRNA reads terminated strings, so the sequence is copied once
+ * into a buffer reused by the thread.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence or ideal is null
+ * - R_EMPTY_PARAMETER | sequence or ideal is empty
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_BAD_PAIR_MATCH | Error in ideal structure bonds
+ * - R_STRUCT_LENGTH_DIFFER | sequence and ideal are different lengths
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details
+ ***********************************************************************************
+ *
+ * @param context Model context of the job, or nullptr for the default model
+ * @param sequence Start of the design sequence to fold
+ * @param sequence_length Length of the sequence
+ * @param ideal Start of the ideal secondary structure
+ * @param ideal_length Length of the ideal
+ * @param weighted_distance Out variable for the sum of distances weighted by fold probability
+ * @param max_distance Out variable for the largest distance of any suboptimal structure
+ * @param probability Out variable for the sum of fold probabilities
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_score_view(const model_context* context, const char* sequence, const size_t sequence_length, const char* ideal, const size_t ideal_length, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability)
+{
+    R_STATUS status = validate_sequence_view(sequence, sequence_length);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (ideal == nullptr && ideal_length != 0) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    structure_ideal* handle = nullptr;
+    status = make_structure_ideal(ideal, ideal_length, handle);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (sequence_length != handle->length) {
+        structure_ideal_free(handle);
         return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
     }
 
-    char* xstruc;
-    Tree* T[2];
+    thread_local std::string terminated;
+    terminated.assign(sequence, sequence_length);
 
-    // Make tree structure for candidate
-    xstruc = expand_Full(candidate);
-    T[0] = make_tree(xstruc);
-    free(xstruc);
+    status = score_against_ideal(terminated.c_str(), *handle, context, weighted_distance, max_distance, probability);
+    structure_ideal_free(handle);
 
-    // Make tree structure for ideal
-    xstruc = expand_Full(ideal);
-    T[1] = make_tree(xstruc);
-    free(xstruc);
+    return status;
+}
 
-    // Calculate distance
-    {
-        // a lock is needed as vrna's tree_edit_distance is not threadsafe
-        std::lock_guard<std::mutex> lock(tree_edit_distance_mutex);
-        distance = tree_edit_distance(T[0], T[1]);
+/*!
+ * \brief Structure score of a design in a model context
+ * Same as `structure_score`, with the design folded with the model details of
+ * the context (temperature, dangles, maximum base pair span) and scored with
+ * its method (see `model_context_set_structure_score_mode`). With
+ * `STRUCTURE_SCORE_ENSEMBLE_DEFECT`, the weighted distance is the ensemble
+ * defect instead, the maximum distance is the length and the probability is 1.
+ * With `STRUCTURE_SCORE_SUBOPT_BAND`, the partition function is skipped and
+ * the probabilities of the band add up to 1.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | context is null
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_BAD_PAIR_MATCH | Error in ideal structure bonds
+ * - R_STRUCT_LENGTH_DIFFER | sequence and ideal are different lengths
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details
+ ***********************************************************************************
+ *
+ * @param context Model context of the job
+ * @param sequence Design sequence to fold
+ * @param ideal Ideal secondary structure
+ * @param weighted_distance Out variable for the sum of distances weighted by fold probability
+ * @param max_distance Out variable for the largest distance of any suboptimal structure
+ * @param probability Out variable for the sum of fold probabilities
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_score_with_context(const model_context* context, const char* sequence, const char* ideal, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability)
+{
+    if (context == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    return score_structure(sequence, ideal, context, weighted_distance, max_distance, probability);
+}
+
+/*!
+ * \brief Structure score of a validated design
+ * Same as `structure_score` (or `structure_score_with_context`), against an
+ * ideal structure parsed with `structure_ideal_create`, without checking the
+ * sequence again.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence or ideal is null
+ * - R_STRUCT_LENGTH_DIFFER | sequence and ideal are different lengths
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details
+ ***********************************************************************************
+ *
+ * @param context Model context of the job, or nullptr for the default model
+ * @param sequence Validated design sequence (see `validated_sequence_create`)
+ * @param ideal Parsed ideal structure
+ * @param weighted_distance Out variable for the sum of distances weighted by fold probability
+ * @param max_distance Out variable for the largest distance of any suboptimal structure
+ * @param probability Out variable for the sum of fold probabilities
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_score_validated(const model_context* context, const validated_sequence* sequence, const structure_ideal* ideal, /*out*/ float& weighted_distance, /*out*/ float& max_distance, /*out*/ float& probability)
+{
+    if (sequence == nullptr || ideal == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (sequence->sequence.size() != ideal->length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    return score_against_ideal(sequence->sequence.c_str(), *ideal, context, weighted_distance, max_distance, probability);
+}
+
+/*!
+ * \brief Batched structure score
+ * Used to compute `structure_score` (or `structure_score_with_context`) for a batch
+ * of designs in a single call, distributing the designs across threads with OpenMP.
+ * Results are stored in input order.
+ *
+ * Understanding return values:
+ * - R_EMPTY_PARAMETER | an input or out array is null, or count is 0
+ * - statuses[i] holds the status code of `structure_score` for design i
+ ***********************************************************************************
+ *
+ * @param context Model context of the job, or nullptr for the default model
+ * @param sequences Design sequences to fold
+ * @param ideals Ideal secondary structures of the designs
+ * @param count Number of designs in the batch
+ * @param thread_count Number of threads to use (0 or less to use all available cores)
+ * @param weighted_distances Out array of weighted distances
+ * @param max_distances Out array of maximum distances
+ * @param probabilities Out array of summed fold probabilities
+ * @param statuses Out array of status codes
+ * @return State Code
+ */
+DLL_PUBLIC R_STATUS structure_score_batch(const model_context* context, const char** sequences, const char** ideals, const size_t count, const int thread_count, /*out*/ float* weighted_distances, /*out*/ float* max_distances, /*out*/ float* probabilities, /*out*/ R_STATUS* statuses)
+{
+    if (sequences == nullptr || ideals == nullptr || weighted_distances == nullptr ||
+        max_distances == nullptr || probabilities == nullptr || statuses == nullptr || count == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
     }
 
-    free_tree(T[0]);
-    free_tree(T[1]);
+#ifdef _OPENMP
+    int threads = thread_count > 0 ? thread_count : omp_get_max_threads();
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(threads)
+#else
+    (void)thread_count;
+#endif
+    for (long long i = 0; i < static_cast<long long>(count); ++i) {
+        weighted_distances[i] = 0.0f;
+        max_distances[i] = 0.0f;
+        probabilities[i] = 0.0f;
+
+        if (sequences[i] == nullptr || ideals[i] == nullptr) {
+            statuses[i] = R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+            continue;
+        }
+
+        statuses[i] = score_structure(sequences[i], ideals[i], context, weighted_distances[i], max_distances[i], probabilities[i]);
+    }
 
     return R_SUCCESS::R_STATUS_OK;
 }
@@ -0,0 +1,287 @@
+#include "dll.h"
+
+#include <cctype>
+#include <cstring>
+
+#include "functions.h"
+#include "anneal.h"
+#include "substrate_template.h"
+#include "pairing_index.h"
+#include "unpaired_profile.h"
+#include "packed_sequence.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*!
+ * \brief Find the binding arms of a substrate structure
+ * Binding arms are the runs of [0-9a-zA-Z] in the substrate structure. Arms of
+ * length 1 are kept; the annealing score skips them.
+ *
+ * \param structure Substrate structure
+ * \param length Length of the substrate structure
+ * \param compiled Out variable for the compiled template
+ */
+void compile_substrate_template(const char* structure, size_t length, /*out*/ substrate_template& compiled)
+{
+    compiled.length = length;
+    compiled.arms.clear();
+
+    size_t i = 0;
+    while (i < length) {
+        if (!std::isalnum(static_cast<unsigned char>(structure[i]))) {
+            ++i;
+            continue;
+        }
+
+        size_t start = i;
+        while (i < length && std::isalnum(static_cast<unsigned char>(structure[i]))) {
+            ++i;
+        }
+
+        compiled.arms.push_back({ start, i - start });
+    }
+}
+
+/*!
+ * \brief Annealing score against a compiled template
+ * Sum of the arm scores of every binding arm, read in place from the packed sequence.
+ *
+ * \param compiled Compiled substrate template
+ * \param sequence Packed substrate sequence, of the template's length
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \return Annealing temperature score
+ */
+double template_anneal(const substrate_template& compiled, const packed_sequence& sequence, const float na_concentration, const float probe_concentration, const float target_temp)
+{
+    double temp_sum = 0.0;
+
+    for (const arm_span& arm : compiled.arms) {
+        // A arm length of 1 will cause melting to crash
+        // Ignore that arm
+        if (arm.length != 1) {
+            temp_sum += arm_score(arm_temperature(sequence, arm.start, arm.length, na_concentration, probe_concentration), target_temp);
+        }
+    }
+
+    return temp_sum;
+}
+
+/*!
+ * \brief Single-strandedness of the binding arms
+ *
+ * \param compiled Compiled substrate template
+ * \param folded_structure Folded structure, of the template's length
+ * \return True if every binding arm is unpaired in the folded structure
+ */
+bool template_single_stranded(const substrate_template& compiled, const char* folded_structure)
+{
+    for (const arm_span& arm : compiled.arms) {
+        for (size_t j = 0; j < arm.length; ++j) {
+            if (folded_structure[arm.start + j] != '.') {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Single-strandedness of the binding arms on an indexed RNA
+ * Each arm is checked in constant time, whatever its length.
+ *
+ * \param compiled Compiled substrate template
+ * \param index Pairing index of the folded RNA
+ * \param offset Position of the substrate on the RNA, with the whole substrate in bounds
+ * \return True if every binding arm is unpaired on the RNA
+ */
+bool template_single_stranded(const substrate_template& compiled, const pairing_index& index, size_t offset)
+{
+    for (const arm_span& arm : compiled.arms) {
+        if (!range_unpaired(index, offset + arm.start, arm.length)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Profiled binding arms
+ *
+ * \param compiled Compiled substrate template
+ * \param profile Unpaired profile of the RNA
+ * \return True if the length of every binding arm is in the profile
+ */
+bool template_profiled(const substrate_template& compiled, const unpaired_profile& profile)
+{
+    for (const arm_span& arm : compiled.arms) {
+        if (!profiled(profile, arm.length)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Probability that the binding arms are single stranded on a profiled RNA
+ * Each arm is looked up in constant time; the arms are taken as independent,
+ * since the profile only holds the probability of each stretch on its own.
+ *
+ * \param compiled Compiled substrate template, with every arm length profiled
+ * \param profile Unpaired profile of the RNA
+ * \param offset Position of the substrate on the RNA, with the whole substrate in bounds
+ * \return Probability that every binding arm is unpaired on the RNA
+ */
+double template_unpaired(const substrate_template& compiled, const unpaired_profile& profile, size_t offset)
+{
+    double probability = 1.0;
+    for (const arm_span& arm : compiled.arms) {
+        probability *= stretch_unpaired(profile, offset + arm.start, arm.length);
+    }
+
+    return probability;
+}
+
+/*!
+ * \brief Create substrate template
+ * Used to compile the binding arms of a substrate structure once, to score
+ * every candidate of the same ribozyme structure with
+ * `substrate_template_anneal` and `substrate_template_accessibility`.
+ *
+ * Understanding return values:
+ * - R_EMPTY_PARAMETER | substrate structure is empty
+ *
+ ***************************************************************************************
+ * \param substrate_structure Substrate structure to determine binding regions
+ * \param handle Out variable for the template, released with `substrate_template_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS substrate_template_create(const char* substrate_structure, /*out*/ substrate_template*& handle)
+{
+    handle = nullptr;
+
+    if (substrate_structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    size_t length = strlen(substrate_structure);
+    if (length == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+    handle = new substrate_template;
+    compile_substrate_template(substrate_structure, length, *handle);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Annealing Temperature Score against a substrate template
+ * Same score as `anneal` for the template's substrate structure.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | template is null
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence and structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************************
+ * \param handle Substrate template
+ * \param sequence Substrate sequence
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temp Out variable for annealing temperature score
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS substrate_template_anneal(const substrate_template* handle, const char* sequence, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temp)
+{
+    if (handle == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    thread_local packed_sequence packed;
+    R_STATUS status = pack_sequence(sequence, packed);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (packed.length != handle->length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    temp = static_cast<float>(template_anneal(*handle, packed, na_concentration, probe_concentration, target_temp));
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Accessibility score against a substrate template
+ * Same score as `accessibility` for the template's substrate structure.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | template is null
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_STRUCT_LENGTH_DIFFER | sequence, structure and folded structure lengths do not match
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************************
+ * \param handle Substrate template
+ * \param substrate_sequence Substrate sequence from candidate
+ * \param folded_structure Structure of target sequence on rna (folded using ViennaRNA)
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param score Out variable for accessibility score
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS substrate_template_accessibility(const substrate_template* handle, const char* substrate_sequence, const char* folded_structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& score)
+{
+    if (handle == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    thread_local packed_sequence packed;
+    R_STATUS status = pack_sequence(substrate_sequence, packed);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (packed.length != handle->length || strlen(folded_structure) != handle->length) {
+        return R_APPLICATION_ERROR::R_STRUCT_LENGTH_DIFFER;
+    }
+
+    status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    if (template_single_stranded(*handle, folded_structure)) {
+        score = 0.0f;
+    } else {
+        score = static_cast<float>(template_anneal(*handle, packed, na_concentration, probe_concentration, target_temp));
+    }
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from substrate template
+ *
+ ***************************************************************************************
+ * @param handle Substrate template to be freed
+ */
+DLL_PUBLIC void substrate_template_free(substrate_template* handle)
+{
+    delete handle;
+}
+
+}
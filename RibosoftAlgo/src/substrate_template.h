@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+struct pairing_index;
+struct unpaired_profile;
+struct packed_sequence;
+
+/*! \struct arm_span
+ * \brief Position of one binding arm in a substrate structure
+ */
+struct arm_span {
+    size_t start; //!< Start of the arm
+    size_t length; //!< Length of the arm
+};
+
+/*! \struct substrate_template
+ * \brief Binding arms of a substrate structure, compiled once and shared by
+ * every candidate of the same ribozyme structure
+ */
+struct substrate_template {
+    size_t length; //!< Length of the substrate structure
+    std::vector<arm_span> arms; //!< Binding arms (runs of [0-9a-zA-Z]), in order
+};
+
+/*! \fn compile_substrate_template
+ * \brief Find the binding arms of a substrate structure
+ * @file substrate_template.cpp
+ */
+void compile_substrate_template(const char* structure, size_t length, /*out*/ substrate_template& compiled);
+
+/*! \fn template_anneal
+ * \brief Annealing score of a packed substrate sequence against a compiled template
+ * @file substrate_template.cpp
+ */
+double template_anneal(const substrate_template& compiled, const packed_sequence& sequence, const float na_concentration, const float probe_concentration, const float target_temp);
+
+/*! \fn template_single_stranded
+ * \brief Whether no binding arm of a compiled template is paired in a folded structure
+ * @file substrate_template.cpp
+ */
+bool template_single_stranded(const substrate_template& compiled, const char* folded_structure);
+
+/*! \fn template_single_stranded
+ * \brief Whether no binding arm of a compiled template is paired on an indexed RNA, at an offset
+ * @file substrate_template.cpp
+ */
+bool template_single_stranded(const substrate_template& compiled, const pairing_index& index, size_t offset);
+
+/*! \fn template_profiled
+ * \brief Whether the length of every binding arm of a compiled template is in an unpaired profile
+ * @file substrate_template.cpp
+ */
+bool template_profiled(const substrate_template& compiled, const unpaired_profile& profile);
+
+/*! \fn template_unpaired
+ * \brief Probability that no binding arm of a compiled template is paired on a profiled RNA, at an offset
+ * @file substrate_template.cpp
+ */
+double template_unpaired(const substrate_template& compiled, const unpaired_profile& profile, size_t offset);
+
+}
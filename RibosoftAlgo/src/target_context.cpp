@@ -0,0 +1,218 @@
+#include "dll.h"
+
+#include <cstring>
+#include <utility>
+
+#include "functions.h"
+#include "anneal.h"
+#include "target_context.h"
+#include "substrate_template.h"
+#include "packed_sequence.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*!
+ * \brief Melting temperature of a substring of the target
+ * Memoized MELTING on the substring, read in place from the packed target.
+ * The temperature is also kept in the context, keyed by position instead of
+ * by the arm's characters, so the next candidates at the same cutsite find it
+ * without unpacking the arm or locking a shared cache shard. The context keeps
+ * the temperatures of one pair of concentrations, those of the last call.
+ *
+ * \param context Target context
+ * \param start Start of the substring on the target
+ * \param length Length of the substring (at least 2)
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \return Melting temperature (in degrees centigrade)
+ */
+double target_temperature(const target_context& context, size_t start, size_t length, const float na_concentration, const float probe_concentration)
+{
+    const std::uint64_t key = (static_cast<std::uint64_t>(start) << 32) | length;
+
+    {
+        std::lock_guard<std::mutex> lock(context.mutex);
+        if (context.na_concentration != na_concentration || context.probe_concentration != probe_concentration) {
+            context.temperatures.clear();
+            context.na_concentration = na_concentration;
+            context.probe_concentration = probe_concentration;
+        }
+
+        auto found = context.temperatures.find(key);
+        if (found != context.temperatures.end()) {
+            return found->second;
+        }
+    }
+
+    const double temperature = arm_temperature(context.sequence, start, length, na_concentration, probe_concentration);
+
+    std::lock_guard<std::mutex> lock(context.mutex);
+    if (context.na_concentration == na_concentration && context.probe_concentration == probe_concentration) {
+        context.temperatures.emplace(key, temperature);
+    }
+
+    return temperature;
+}
+
+/*!
+ * \brief Annealing score of a substrate on the target
+ * Same as `template_anneal`, with each binding arm's melting temperature read
+ * from the target context.
+ *
+ * \param context Target context
+ * \param compiled Compiled substrate template, within the target at the offset
+ * \param offset Start of the substrate on the target (cutsite index)
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \return Annealing temperature score
+ */
+double target_anneal(const target_context& context, const substrate_template& compiled, size_t offset, const float na_concentration, const float probe_concentration, const float target_temp)
+{
+    double temp_sum = 0.0;
+
+    for (const arm_span& arm : compiled.arms) {
+        // A arm length of 1 will cause melting to crash
+        // Ignore that arm
+        if (arm.length != 1) {
+            temp_sum += arm_score(target_temperature(context, offset + arm.start, arm.length, na_concentration, probe_concentration), target_temp);
+        }
+    }
+
+    return temp_sum;
+}
+
+/*!
+ * \brief Create target context
+ * Used to validate and pack a target RNA once, for every substrate on it.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | rna is null
+ * - R_EMPTY_PARAMETER | rna is empty
+ * - R_INVALID_NUCLEOTIDE | rna has an invalid nucleotide
+ *
+ ***************************************************************************************
+ * \param rna Target RNA sequence
+ * \param context Out variable for the target context, released with `target_context_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS target_context_create(const char* rna, /*out*/ target_context*& context)
+{
+    packed_sequence packed;
+    R_STATUS status = pack_sequence(rna, packed);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    context = new target_context;
+    context->sequence = std::move(packed);
+    context->na_concentration = 0.0f;
+    context->probe_concentration = 0.0f;
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Melting temperature on the target
+ * Used to calculate the melting temperature of a substring of the target RNA
+ * with its complement, without copying it.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | context is null
+ * - R_OUT_OF_RANGE | the substring is not within the target
+ * - R_INVALID_ARM_LENGTH | length is less than 2
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************************
+ * \param context Target context
+ * \param start Start of the substring on the target
+ * \param length Length of the substring
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param temp Out variable for the melting temperature (in degrees centigrade)
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS target_context_melting(const target_context* context, const size_t start, const size_t length, const float na_concentration, const float probe_concentration, /*out*/ float& temp)
+{
+    if (context == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (start > context->sequence.length || length > context->sequence.length - start) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    if (length < 2) {
+        return R_APPLICATION_ERROR::R_INVALID_ARM_LENGTH;
+    }
+
+    R_STATUS status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    temp = static_cast<float>(target_temperature(*context, start, length, na_concentration, probe_concentration));
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Annealing Temperature Score on the target
+ * Same score as `anneal` for the substrate starting at `offset` on the target,
+ * with each binding arm's melting temperature read from the target context.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | context or substrate_structure is null
+ * - R_EMPTY_PARAMETER | substrate_structure is empty
+ * - R_OUT_OF_RANGE | the substrate is not within the target
+ * - R_INVALID_CONCENTRATION | na_concentration or probe_concentration are out of range
+ *
+ ***************************************************************************************
+ * \param context Target context
+ * \param offset Start of the substrate on the target (cutsite index)
+ * \param substrate_structure Substrate structure to determine binding regions
+ * \param na_concentration Sodium (Na+) concentration (in moles)
+ * \param probe_concentration Nucleic acid concentration in excess (in moles)
+ * \param target_temp Target temperature of binding arms
+ * \param temp Out variable for annealing temperature score
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS target_context_anneal(const target_context* context, const size_t offset, const char* substrate_structure, const float na_concentration, const float probe_concentration, const float target_temp, /*out*/ float& temp)
+{
+    if (context == nullptr || substrate_structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    size_t length = strlen(substrate_structure);
+    if (length == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+    if (offset > context->sequence.length || length > context->sequence.length - offset) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    R_STATUS status = validate_concentrations(na_concentration, probe_concentration);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    thread_local substrate_template compiled;
+    compile_substrate_template(substrate_structure, length, compiled);
+
+    temp = static_cast<float>(target_anneal(*context, compiled, offset, na_concentration, probe_concentration, target_temp));
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from target context
+ *
+ ***************************************************************************************
+ * @param context Target context to be freed
+ */
+DLL_PUBLIC void target_context_free(target_context* context)
+{
+    delete context;
+}
+
+}
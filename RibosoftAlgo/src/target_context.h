@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+
+#include "packed_sequence.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+struct substrate_template;
+
+/*! \struct target_context
+ * \brief Target RNA validated and packed once, so that the binding arms of
+ * every substrate on it are read in place, with the melting temperature of
+ * each substring computed at most once per conditions
+ */
+struct target_context {
+    packed_sequence sequence; //!< Target RNA sequence, 2 bits per nucleotide
+    mutable std::mutex mutex; //!< Mutex to lock access to the temperatures
+    mutable float na_concentration; //!< Sodium (Na+) concentration of the temperatures (in moles)
+    mutable float probe_concentration; //!< Nucleic acid concentration in excess of the temperatures (in moles)
+    mutable std::unordered_map<std::uint64_t, double> temperatures; //!< Melting temperatures of the substrings read so far, by start (high bits) and length
+};
+
+/*! \fn target_temperature
+ * \brief Melting temperature of the substring [start, start + length) of the target
+ * @file target_context.cpp
+ */
+double target_temperature(const target_context& context, size_t start, size_t length, const float na_concentration, const float probe_concentration);
+
+/*! \fn target_anneal
+ * \brief Annealing score of the substrate starting at an offset of the target against a compiled template
+ * @file target_context.cpp
+ */
+double target_anneal(const target_context& context, const substrate_template& compiled, size_t offset, const float na_concentration, const float probe_concentration, const float target_temp);
+
+}
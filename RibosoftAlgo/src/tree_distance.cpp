@@ -0,0 +1,220 @@
+#include "dll.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tree_distance.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*! \enum TREE_NODE
+ * \brief Node labels of the full structure representation
+ */
+enum TREE_NODE : std::uint8_t {
+    TREE_NODE_UNPAIRED = 0, //!< Unpaired base (U)
+    TREE_NODE_PAIR     = 1, //!< Base pair (P)
+    TREE_NODE_ROOT     = 2, //!< Root of the structure (R)
+};
+
+constexpr int FORBIDDEN_COST = 1 << 20; //!< Cost of an edit that is never part of a shortest script, as ViennaRNA's `DIST_INF`
+
+/*!
+ * \brief Cost of inserting or deleting a U, P or R node, as in ViennaRNA's `UsualCost`
+ */
+constexpr int INSERT_DELETE_COST[] = { 1, 2, FORBIDDEN_COST };
+
+/*!
+ * \brief Cost of relabelling a U, P or R node (rows) into a U, P or R node (columns),
+ * as in ViennaRNA's `UsualCost`: an unpaired base and a pair are one edit apart, the
+ * root only ever matches the root
+ */
+constexpr int RELABEL_COST[3][3] = {
+    { 0, 1, FORBIDDEN_COST },
+    { 1, 0, FORBIDDEN_COST },
+    { FORBIDDEN_COST, FORBIDDEN_COST, 0 },
+};
+
+/*! \struct tree_distance_workspace
+ * \brief Per-thread scratch matrices for the tree edit distance
+ */
+struct tree_distance_workspace {
+    std::vector<int> tree_distance; //!< Distances between subtrees
+    std::vector<int> forest_distance; //!< Distances between forests of the current keyroot pair
+};
+
+thread_local tree_distance_workspace workspace; //!< Workspace of the current thread, grown as needed and never shared
+
+/*!
+ * \brief Build the ordered tree of a structure
+ * Nodes are emitted in postorder: an unpaired base as soon as it is read, a base pair
+ * on its closing position and the root last.
+ *
+ * @param length Length of the structure
+ * @param element Kind of each position: '(' opens a pair, ')' closes one, anything else is unpaired
+ * @param tree Out variable for the tree
+ */
+template <typename Element>
+static void build_structure_tree(size_t length, Element element, /*out*/ structure_tree& tree)
+{
+    tree.labels.clear();
+    tree.leftmost.clear();
+    tree.keyroots.clear();
+    tree.labels.reserve(length + 1);
+    tree.leftmost.reserve(length + 1);
+
+    // leftmost leaf of the first child of each open pair (root at the bottom), -1 while childless
+    thread_local std::vector<int> first_leaf;
+    first_leaf.clear();
+    first_leaf.push_back(-1);
+
+    auto emit = [&](std::uint8_t label, int leftmost) {
+        int index = static_cast<int>(tree.labels.size());
+        if (leftmost < 0) {
+            leftmost = index;
+        }
+
+        tree.labels.push_back(label);
+        tree.leftmost.push_back(leftmost);
+
+        return leftmost;
+    };
+
+    for (size_t i = 0; i < length; ++i) {
+        const char kind = element(i);
+        if (kind == '(') {
+            first_leaf.push_back(-1);
+        } else if (kind == ')') {
+            int leftmost = emit(TREE_NODE_PAIR, first_leaf.back());
+            first_leaf.pop_back();
+            if (first_leaf.back() < 0) {
+                first_leaf.back() = leftmost;
+            }
+        } else {
+            int leftmost = emit(TREE_NODE_UNPAIRED, -1);
+            if (first_leaf.back() < 0) {
+                first_leaf.back() = leftmost;
+            }
+        }
+    }
+
+    emit(TREE_NODE_ROOT, first_leaf.front());
+
+    // keyroots are the highest node of each leftmost leaf
+    int size = static_cast<int>(tree.labels.size());
+    std::vector<bool> seen(size, false);
+    for (int i = size - 1; i >= 0; --i) {
+        if (!seen[tree.leftmost[i]]) {
+            seen[tree.leftmost[i]] = true;
+            tree.keyroots.push_back(i);
+        }
+    }
+    std::reverse(tree.keyroots.begin(), tree.keyroots.end());
+}
+
+/*!
+ * \brief Build the ordered tree of a dot-bracket structure
+ * Only `(` and `)` are pairs; every other element is an unpaired base, as
+ * with `expand_Full`.
+ *
+ * @param structure Secondary structure, with balanced brackets
+ * @param length Length of the structure
+ * @param tree Out variable for the tree
+ */
+void make_structure_tree(const char* structure, size_t length, /*out*/ structure_tree& tree)
+{
+    build_structure_tree(length, [structure](size_t i) { return structure[i]; }, tree);
+}
+
+/*!
+ * \brief Build the ordered tree of a pair table
+ * Same tree as from the dot-bracket structure, without reading it again.
+ *
+ * @param pairs Partner of each position in `(` `)` pairs, or -1 (pseudoknot brackets count as unpaired)
+ * @param tree Out variable for the tree
+ */
+void make_structure_tree(const std::vector<int>& pairs, /*out*/ structure_tree& tree)
+{
+    build_structure_tree(pairs.size(), [&pairs](size_t i) {
+        const int partner = pairs[i];
+        return partner < 0 ? '.' : (static_cast<size_t>(partner) > i ? '(' : ')');
+    }, tree);
+}
+
+/*!
+ * \brief Tree edit distance
+ * Zhang-Shasha ordered tree edit distance between two structure trees, with the
+ * unit costs ViennaRNA's `tree_edit_distance` uses for the full representation.
+ * All scratch memory is thread-local, so calls from different threads run
+ * concurrently without locking.
+ *
+ * @param first First structure tree
+ * @param second Second structure tree
+ * @return Distance
+ */
+float structure_tree_distance(const structure_tree& first, const structure_tree& second)
+{
+    const int n = static_cast<int>(first.labels.size());
+    const int m = static_cast<int>(second.labels.size());
+
+    std::vector<int>& td = workspace.tree_distance;
+    std::vector<int>& fd = workspace.forest_distance;
+    if (td.size() < static_cast<size_t>(n) * m) {
+        td.resize(static_cast<size_t>(n) * m);
+    }
+    if (fd.size() < static_cast<size_t>(n + 1) * (m + 1)) {
+        fd.resize(static_cast<size_t>(n + 1) * (m + 1));
+    }
+
+    const std::uint8_t* a = first.labels.data();
+    const std::uint8_t* b = second.labels.data();
+    const int* la = first.leftmost.data();
+    const int* lb = second.leftmost.data();
+
+    for (int i : first.keyroots) {
+        for (int j : second.keyroots) {
+            const int li = la[i];
+            const int lj = lb[j];
+            const int rows = i - li + 2;
+            const int cols = j - lj + 2;
+
+            // forest rows/columns are offset so that index 0 is the empty forest
+            auto forest = [&](int x, int y) -> int& { return fd[static_cast<size_t>(x) * cols + y]; };
+
+            forest(0, 0) = 0;
+            for (int x = 1; x < rows; ++x) {
+                forest(x, 0) = forest(x - 1, 0) + INSERT_DELETE_COST[a[li + x - 1]];
+            }
+            for (int y = 1; y < cols; ++y) {
+                forest(0, y) = forest(0, y - 1) + INSERT_DELETE_COST[b[lj + y - 1]];
+            }
+
+            for (int x = 1; x < rows; ++x) {
+                const int node_a = li + x - 1;
+                const int delete_cost = INSERT_DELETE_COST[a[node_a]];
+
+                for (int y = 1; y < cols; ++y) {
+                    const int node_b = lj + y - 1;
+                    const int insert_cost = INSERT_DELETE_COST[b[node_b]];
+
+                    int distance = std::min(forest(x - 1, y) + delete_cost, forest(x, y - 1) + insert_cost);
+
+                    if (la[node_a] == li && lb[node_b] == lj) {
+                        // both forests are whole trees
+                        const int relabel = RELABEL_COST[a[node_a]][b[node_b]];
+                        distance = std::min(distance, forest(x - 1, y - 1) + relabel);
+                        td[static_cast<size_t>(node_a) * m + node_b] = distance;
+                    } else {
+                        distance = std::min(distance, forest(la[node_a] - li, lb[node_b] - lj) + td[static_cast<size_t>(node_a) * m + node_b]);
+                    }
+
+                    forest(x, y) = distance;
+                }
+            }
+        }
+    }
+
+    return static_cast<float>(td[static_cast<size_t>(n - 1) * m + (m - 1)]);
+}
+
+}
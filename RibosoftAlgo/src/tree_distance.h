@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*! \struct structure_tree
+ * \brief Ordered tree of a secondary structure, in the full representation
+ * used by ViennaRNA's `expand_Full` (one node per unpaired base, one node
+ * per base pair, and a root), stored in postorder.
+ */
+struct structure_tree {
+    std::vector<std::uint8_t> labels; //!< Node label, in postorder
+    std::vector<int> leftmost; //!< Postorder index of the leftmost leaf of each node
+    std::vector<int> keyroots; //!< Keyroots of the tree, in increasing order
+};
+
+/*! \fn make_structure_tree
+ * \brief Build the ordered tree of a (validated) dot-bracket structure
+ * @file tree_distance.cpp
+ */
+void make_structure_tree(const char* structure, size_t length, /*out*/ structure_tree& tree);
+
+/*! \fn make_structure_tree
+ * \brief Build the ordered tree of a pair table, pseudoknot pairs already dropped
+ * @file tree_distance.cpp
+ */
+void make_structure_tree(const std::vector<int>& pairs, /*out*/ structure_tree& tree);
+
+/*! \fn structure_tree_distance
+ * \brief Reentrant tree edit distance between two structure trees
+ * @file tree_distance.cpp
+ */
+float structure_tree_distance(const structure_tree& first, const structure_tree& second);
+
+}
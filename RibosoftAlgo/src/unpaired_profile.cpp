@@ -0,0 +1,151 @@
+#include "dll.h"
+
+#include <cstring>
+#include <algorithm>
+#include <limits>
+
+#include "functions.h"
+#include "unpaired_profile.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*!
+ * \brief Store the unpaired probabilities of the stretches ending at a position
+ *
+ * \param position 0-based position where the stretches end
+ * \param probabilities probabilities[u - 1] for the stretch of length u
+ * \param count Number of stretch lengths
+ * \param data Profile being filled
+ * \return 1 to keep receiving probabilities
+ */
+static int profile_unpaired(size_t position, const float* probabilities, size_t count, void* data)
+{
+    unpaired_profile& profile = *static_cast<unpaired_profile*>(data);
+
+    // stretches ending at position start at position + 1 - stretch, so longer ones do not fit
+    for (size_t stretch = 1; stretch <= count; ++stretch) {
+        if (profiled(profile, stretch) && stretch <= position + 1) {
+            profile.probabilities[static_cast<size_t>(profile.rows[stretch]) * profile.length + position + 1 - stretch] = probabilities[stretch - 1];
+        }
+    }
+
+    return 1;
+}
+
+/*!
+ * \brief Create unpaired profile
+ * Used to fold the ensemble of an RNA once, keeping for each stretch length in
+ * use (the binding arm lengths) the probability that the stretch of that length
+ * starting at each position is unpaired. The accessibility of a candidate at
+ * any cutsite is then found in constant time with `candidate_score_profiled`.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence or stretch lengths are null, or a stretch length is not within [1, window]
+ * (the window shortened to the sequence)
+ * - R_EMPTY_PARAMETER | sequence is empty, or no stretch length is given
+ * - R_INVALID_NUCLEOTIDE | sequence has an invalid nucleotide
+ * - R_OUT_OF_RANGE | window or base pair span is invalid (see `local_fold_stream`)
+ * - R_VIENNA_RNA_ERROR | Error from ViennaRNA, contact us with more details.
+ *
+ ***************************************************************************************
+ * \param context Model context of the job, or nullptr for the default model
+ * \param rna_sequence RNA sequence
+ * \param stretch_lengths Stretch lengths to profile, in any order
+ * \param count Number of stretch lengths
+ * \param window_size Size of the sliding window (0 for the whole RNA)
+ * \param max_bp_span Maximum span of a base pair (0 for the window size)
+ * \param handle Out variable for the profile, released with `unpaired_profile_free`
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS unpaired_profile_create(const model_context* context, const char* rna_sequence, const int* stretch_lengths, const size_t count, const int window_size, const int max_bp_span, /*out*/ unpaired_profile*& handle)
+{
+    handle = nullptr;
+
+    if (rna_sequence == nullptr || stretch_lengths == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (rna_sequence[0] == '\0' || count == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+    const size_t length = strlen(rna_sequence);
+    const int window = window_size == 0 ? static_cast<int>(std::min<size_t>(length, std::numeric_limits<int>::max())) : window_size;
+
+    // the rows are sized by the longest stretch, so every length is bounded by the
+    // sequence before allocating (an invalid window is left to `local_unpaired_stream`)
+    const size_t limit = window > 0 ? std::min(static_cast<size_t>(window), length) : length;
+    int longest = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (stretch_lengths[i] < 1 || static_cast<size_t>(stretch_lengths[i]) > limit) {
+            return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+        }
+
+        longest = std::max(longest, stretch_lengths[i]);
+    }
+
+    unpaired_profile* profile = new unpaired_profile;
+    profile->length = length;
+    profile->rows.assign(static_cast<size_t>(longest) + 1, -1);
+
+    int rows = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (profile->rows[stretch_lengths[i]] < 0) {
+            profile->rows[stretch_lengths[i]] = rows++;
+        }
+    }
+
+    // stretches running past the 3' end are never streamed and stay at 0
+    profile->probabilities.assign(static_cast<size_t>(rows) * profile->length, 0.0f);
+
+    R_STATUS status = local_unpaired_stream(context, rna_sequence, window, max_bp_span, longest, &profile_unpaired, profile);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        delete profile;
+        return status;
+    }
+
+    handle = profile;
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Unpaired probability of a stretch of the profiled RNA
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | profile is null
+ * - R_OUT_OF_RANGE | the stretch length is not profiled, or the stretch is not within the RNA
+ *
+ ***************************************************************************************
+ * \param handle Unpaired profile
+ * \param start Start of the stretch
+ * \param length Length of the stretch
+ * \param probability Out variable for the probability that no position of the stretch is paired
+ * \return Status Code
+ */
+DLL_PUBLIC R_STATUS unpaired_profile_probability(const unpaired_profile* handle, const size_t start, const size_t length, /*out*/ float& probability)
+{
+    if (handle == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    if (!profiled(*handle, length) || start > handle->length || length > handle->length - start) {
+        return R_APPLICATION_ERROR::R_OUT_OF_RANGE;
+    }
+
+    probability = stretch_unpaired(*handle, start, length);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from unpaired profile
+ *
+ ***************************************************************************************
+ * @param handle Unpaired profile to be freed
+ */
+DLL_PUBLIC void unpaired_profile_free(unpaired_profile* handle)
+{
+    delete handle;
+}
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*! \struct unpaired_profile
+ * \brief Probability that each stretch of the profiled lengths is unpaired in
+ * the ensemble of an RNA, one row per stretch length, so the probability of any
+ * stretch is found in constant time
+ */
+struct unpaired_profile {
+    size_t length; //!< Length of the RNA
+    std::vector<int> rows; //!< rows[L] is the row of stretches of length L, or -1 if L is not profiled
+    std::vector<float> probabilities; //!< probabilities[row * length + start] for the stretch starting at start
+};
+
+/*! \fn profiled
+ * \brief Whether stretches of a length are in the profile
+ */
+inline bool profiled(const unpaired_profile& profile, size_t stretch)
+{
+    return stretch < profile.rows.size() && profile.rows[stretch] >= 0;
+}
+
+/*! \fn stretch_unpaired
+ * \brief Probability that [start, start + stretch) is unpaired (length must be profiled and the stretch in bounds)
+ */
+inline float stretch_unpaired(const unpaired_profile& profile, size_t start, size_t stretch)
+{
+    return profile.probabilities[static_cast<size_t>(profile.rows[stretch]) * profile.length + start];
+}
+
+}
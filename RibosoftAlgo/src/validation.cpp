@@ -1,15 +1,108 @@
 #include "dll.h"
 
+#include <cstdint>
 #include <cstring>
-#include <regex>
-#include <stack>
+#include <algorithm>
+#include <bit>
+#include <utility>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
 
 #include "functions.h"
+#include "validation.h"
 
 //! \namespace ribosoft
 namespace ribosoft {
 
-#define EMPTY(str) if (strlen(str) == 0) return R_APPLICATION_ERROR::R_EMPTY_PARAMETER; //!< Macro to determine if parameter is empty
+#if defined(__AVX2__)
+
+/*!
+ * \brief Mask of the bytes of a block that are not A, C, G or U
+ *
+ * \param block 32-byte block
+ * \return Bit i is set if byte i is not a nucleotide
+ */
+static inline std::uint32_t invalid_mask(const __m256i block)
+{
+    const __m256i valid = _mm256_or_si256(
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('A')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('C'))),
+        _mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('G')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('U'))));
+    return ~static_cast<std::uint32_t>(_mm256_movemask_epi8(valid));
+}
+
+typedef __m256i nucleotide_block; //!< Block of bytes checked at once
+#define LOADU_BLOCK(p) _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)) //!< Unaligned load of a block
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+/*!
+ * \brief Mask of the bytes of a block that are not A, C, G or U
+ *
+ * \param block 16-byte block
+ * \return Bit i is set if byte i is not a nucleotide
+ */
+static inline std::uint32_t invalid_mask(const __m128i block)
+{
+    const __m128i valid = _mm_or_si128(
+        _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('A')), _mm_cmpeq_epi8(block, _mm_set1_epi8('C'))),
+        _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('G')), _mm_cmpeq_epi8(block, _mm_set1_epi8('U'))));
+    return ~static_cast<std::uint32_t>(_mm_movemask_epi8(valid)) & 0xFFFFu;
+}
+
+typedef __m128i nucleotide_block; //!< Block of bytes checked at once
+#define LOADU_BLOCK(p) _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)) //!< Unaligned load of a block
+
+#endif
+
+/*!
+ * \brief First invalid nucleotide of a view
+ * Scans the view once, with SSE2 or AVX2 a whole block at a time: blocks are
+ * read unaligned, and never past the view; the characters after the last
+ * whole block are checked one by one.
+ *
+ * \param sequence Start of the view
+ * \param length Length of the view
+ * \return Position of the first character that is not A, C, G or U, or the length if there is none
+ */
+size_t first_invalid_nucleotide(const char* sequence, size_t length)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64)
+    constexpr size_t width = sizeof(nucleotide_block);
+    for (; i + width <= length; i += width) {
+        const std::uint32_t mask = invalid_mask(LOADU_BLOCK(sequence + i));
+        if (mask != 0) {
+            return i + std::countr_zero(mask);
+        }
+    }
+#endif
+
+    for (; i < length; ++i) {
+        const char c = sequence[i];
+        if (c != 'A' && c != 'C' && c != 'G' && c != 'U') {
+            return i;
+        }
+    }
+
+    return length;
+}
+
+/*!
+ * \brief First invalid nucleotide
+ * The terminator is found first, so the block scan of the view never reads
+ * past the sequence.
+ *
+ * \param sequence Sequence to be scanned
+ * \return Position of the first character that is not A, C, G or U, or the length if there is none
+ */
+size_t first_invalid_nucleotide(const char* sequence)
+{
+    return first_invalid_nucleotide(sequence, strlen(sequence));
+}
 
 /*!
  * \brief Sequence Validation
@@ -24,16 +117,170 @@ namespace ribosoft {
  */
 R_STATUS validate_sequence(const char* sequence)
 {
-    EMPTY(sequence);
+    size_t position;
+    return validate_sequence_position(sequence, position);
+}
+
+/*!
+ * \brief Sequence Validation with the position of the error
+ * Same validation as `validate_sequence`, in one pass over the sequence.
+ *
+ * Understanding return values:
+ * - R_EMPTY_PARAMETER | sequence is empty
+ * - R_INVALID_NUCLEOTIDE | Invalid nucleotide found in sequence
+ *************************************************************************
+ *
+ * @param sequence Sequence to be validated
+ * @param position Out variable for the position of the first invalid nucleotide, or the length of a valid sequence
+ * @return Status Code
+ */
+R_STATUS validate_sequence_position(const char* sequence, /*out*/ size_t& position)
+{
+    position = first_invalid_nucleotide(sequence);
+
+    if (sequence[position] != '\0') {
+        return R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE;
+    }
+
+    if (position == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Sequence Validation of a view
+ * Same validation as `validate_sequence`, on `length` characters that need not
+ * be terminated (for example a range of a longer RNA).
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null
+ * - R_EMPTY_PARAMETER | length is 0
+ * - R_INVALID_NUCLEOTIDE | Invalid nucleotide found in sequence
+ *************************************************************************
+ *
+ * @param sequence Start of the sequence
+ * @param length Length of the sequence
+ * @return Status Code
+ */
+R_STATUS validate_sequence_view(const char* sequence, const size_t length)
+{
+    if (length == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+    if (sequence == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
 
-    std::regex nucleotides("[^ACGU]+");
-    if (std::regex_search(sequence, nucleotides)) {
+    if (first_invalid_nucleotide(sequence, length) != length) {
         return R_APPLICATION_ERROR::R_INVALID_NUCLEOTIDE;
     }
 
     return R_SUCCESS::R_STATUS_OK;
 }
 
+/*!
+ * \brief Pair table of a structure
+ * Validates the elements and the bonds of a structure in a single pass, with
+ * no limit on its length. Open brackets waiting for their partner are chained
+ * through the table itself (each one holds the previous open bracket of its
+ * kind), so no stack is allocated besides the table.
+ *
+ * Understanding return values:
+ * - R_EMPTY_PARAMETER | structure is empty
+ * - R_INVALID_STRUCT_ELEMENT | Element in structure is invalid
+ * - R_BAD_PAIR_MATCH | Bonds are not perfect in structure
+ ***************************************************************
+ *
+ * @param structure Structure to be validated, not necessarily terminated
+ * @param length Length of the structure
+ * @param pairs Out variable for the partner of each position in `()` or `{}` pairs, or -1
+ * @return Status Code
+ */
+R_STATUS make_pair_table(const char* structure, size_t length, /*out*/ std::vector<int>& pairs)
+{
+    pairs.assign(length, -1);
+    if (length == 0) {
+        return R_APPLICATION_ERROR::R_EMPTY_PARAMETER;
+    }
+
+    int open_bond = -1;
+    int open_pseudoknot = -1;
+    bool matched = true;
+
+    for (int i = 0; i < static_cast<int>(length); ++i) {
+        int* open = nullptr;
+        switch (structure[i]) {
+        case '.':
+            continue;
+        case '(':
+            pairs[i] = open_bond;
+            open_bond = i;
+            continue;
+        case '{':
+            pairs[i] = open_pseudoknot;
+            open_pseudoknot = i;
+            continue;
+        case ')':
+            open = &open_bond;
+            break;
+        case '}':
+            open = &open_pseudoknot;
+            break;
+        default:
+            return R_APPLICATION_ERROR::R_INVALID_STRUCT_ELEMENT;
+        }
+
+        // keep reading after a bad bond, invalid elements are reported first
+        if (*open < 0) {
+            matched = false;
+            continue;
+        }
+
+        const int partner = *open;
+        *open = pairs[partner];
+        pairs[partner] = i;
+        pairs[i] = partner;
+    }
+
+    if (!matched || open_bond >= 0 || open_pseudoknot >= 0) {
+        return R_APPLICATION_ERROR::R_BAD_PAIR_MATCH;
+    }
+
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Pair table of a terminated structure
+ *
+ * @param structure Structure to be validated
+ * @param pairs Out variable for the partner of each position in `()` or `{}` pairs, or -1
+ * @return Status Code
+ */
+R_STATUS make_pair_table(const char* structure, /*out*/ std::vector<int>& pairs)
+{
+    return make_pair_table(structure, strlen(structure), pairs);
+}
+
+/*!
+ * \brief Bond pairs of a pair table
+ * Pseudoknot brackets count as unpaired in the structure trees and the ensemble
+ * defect, so their partners are cleared.
+ *
+ * @param structure Structure the pair table was made from
+ * @param pairs Pair table of the structure, left with the partners of `()` pairs only
+ */
+void keep_bond_pairs(const char* structure, std::vector<int>& pairs)
+{
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        if (structure[i] == '{' || structure[i] == '}') {
+            pairs[i] = -1;
+        }
+    }
+}
+
 /*!
  * \brief Used to determine if structure has proper bonds
  *
@@ -47,45 +294,168 @@ R_STATUS validate_sequence(const char* sequence)
  */
 R_STATUS validate_structure(const char* structure)
 {
-    EMPTY(structure);
-
-    std::regex structs("[^.(){}]+");
-    if (std::regex_search(structure, structs)) {
-        return R_APPLICATION_ERROR::R_INVALID_STRUCT_ELEMENT;
-    }
-
-    std::stack<idx_t> dblBonds;
-    std::stack<idx_t> pseudoKnots;
-
-    size_t len = strlen(structure);
-    for (idx_t i = 0; i < len; ++i) {
-        char element = structure[i];
-        if (element == '(') {
-            dblBonds.push(i);
-        } else if (element == '{') {
-            pseudoKnots.push(i);
-        } else if (element == ')') {
-            if (dblBonds.empty()) {
-                return R_APPLICATION_ERROR::R_BAD_PAIR_MATCH;
-            }
-            dblBonds.pop();
-        } else if (element == '}') {
-            if (pseudoKnots.empty()) {
-                return R_APPLICATION_ERROR::R_BAD_PAIR_MATCH;
-            }
-            pseudoKnots.pop();
-        }
+    thread_local std::vector<int> pairs;
+    return make_pair_table(structure, pairs);
+}
+
+/*!
+ * \brief Structure Validation of a view
+ * Same validation as `validate_structure`, on `length` characters that need
+ * not be terminated.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | structure is null
+ * - R_EMPTY_PARAMETER | length is 0
+ * - R_INVALID_STRUCT_ELEMENT | Element in structure is invalid
+ * - R_BAD_PAIR_MATCH | Bonds are not perfect in structure
+ ***************************************************************
+ *
+ * @param structure Start of the structure
+ * @param length Length of the structure
+ * @return Status Code
+ */
+R_STATUS validate_structure_view(const char* structure, const size_t length)
+{
+    if (structure == nullptr && length != 0) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
     }
 
-    if (!dblBonds.empty()) {
-        return R_APPLICATION_ERROR::R_BAD_PAIR_MATCH;
+    thread_local std::vector<int> pairs;
+    return make_pair_table(structure, length, pairs);
+}
+
+/*!
+ * \brief Pair table of a validated structure
+ * Same validation as `validate_structure`, keeping the pairing it finds.
+ *
+ * Understanding return values:
+ * - R_EMPTY_PARAMETER | structure is empty
+ * - R_INVALID_STRUCT_ELEMENT | Element in structure is invalid
+ * - R_BAD_PAIR_MATCH | Bonds are not perfect in structure
+ ***************************************************************
+ *
+ * @param structure Structure to be validated
+ * @param pairs Out array with the partner of each position in `()` or `{}` pairs, or -1, released with `pair_table_free`
+ * @param length Out variable for the length of the structure
+ * @return Status Code
+ */
+R_STATUS validate_structure_pairs(const char* structure, /*out*/ int*& pairs, /*out*/ size_t& length)
+{
+    pairs = nullptr;
+    length = 0;
+
+    thread_local std::vector<int> table;
+    R_STATUS status = make_pair_table(structure, table);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
     }
 
-    if (!pseudoKnots.empty()) {
-        return R_APPLICATION_ERROR::R_BAD_PAIR_MATCH;
+    length = table.size();
+    pairs = new int[length];
+    std::copy(table.begin(), table.end(), pairs);
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from a pair table
+ *
+ ***************************************************************
+ * @param pairs Pair table to be freed
+ */
+void pair_table_free(int* pairs)
+{
+    delete[] pairs;
+}
+
+/*!
+ * \brief Create validated sequence
+ * Used to validate a sequence once, for the `*_validated` exports, which take
+ * it without checking it again (for example a substrate sequence scored at
+ * every cutsite).
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | sequence is null
+ * - R_EMPTY_PARAMETER | sequence is empty
+ * - R_INVALID_NUCLEOTIDE | Invalid nucleotide found in sequence
+ ***************************************************************
+ *
+ * @param sequence Sequence to be validated
+ * @param handle Out variable for the validated sequence, released with `validated_sequence_free`
+ * @return Status Code
+ */
+R_STATUS validated_sequence_create(const char* sequence, /*out*/ validated_sequence*& handle)
+{
+    handle = nullptr;
+
+    if (sequence == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
     }
 
+    packed_sequence packed;
+    R_STATUS status = pack_sequence(sequence, packed);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    handle = new validated_sequence{ std::string(sequence, packed.length), std::move(packed) };
     return R_SUCCESS::R_STATUS_OK;
 }
 
-}
\ No newline at end of file
+/*!
+ * \brief Free memory from validated sequence
+ *
+ ***************************************************************
+ * @param handle Validated sequence to be freed
+ */
+void validated_sequence_free(validated_sequence* handle)
+{
+    delete handle;
+}
+
+/*!
+ * \brief Create validated structure
+ * Used to validate a dot-bracket structure once, for the `*_validated`
+ * exports, which take it without checking it again.
+ *
+ * Understanding return values:
+ * - R_INVALID_PARAMETER | structure is null
+ * - R_EMPTY_PARAMETER | structure is empty
+ * - R_INVALID_STRUCT_ELEMENT | Element in structure is invalid
+ * - R_BAD_PAIR_MATCH | Bonds are not perfect in structure
+ ***************************************************************
+ *
+ * @param structure Structure to be validated
+ * @param handle Out variable for the validated structure, released with `validated_structure_free`
+ * @return Status Code
+ */
+R_STATUS validated_structure_create(const char* structure, /*out*/ validated_structure*& handle)
+{
+    handle = nullptr;
+
+    if (structure == nullptr) {
+        return R_APPLICATION_ERROR::R_INVALID_PARAMETER;
+    }
+
+    std::vector<int> pairs;
+    R_STATUS status = make_pair_table(structure, pairs);
+    if (status != R_SUCCESS::R_STATUS_OK) {
+        return status;
+    }
+
+    keep_bond_pairs(structure, pairs);
+    handle = new validated_structure{ std::move(pairs) };
+    return R_SUCCESS::R_STATUS_OK;
+}
+
+/*!
+ * \brief Free memory from validated structure
+ *
+ ***************************************************************
+ * @param handle Validated structure to be freed
+ */
+void validated_structure_free(validated_structure* handle)
+{
+    delete handle;
+}
+
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "functions.h"
+#include "packed_sequence.h"
+
+//! \namespace ribosoft
+namespace ribosoft {
+
+/*! \struct validated_sequence
+ * \brief Sequence checked once to hold only A, C, G and U, for the exports that take it without checking it again
+ */
+struct validated_sequence {
+    std::string sequence; //!< Validated sequence, terminated, as ViennaRNA reads it
+    packed_sequence packed; //!< Validated sequence with 2 bits per nucleotide, for the annealing templates
+};
+
+/*! \struct validated_structure
+ * \brief Dot-bracket structure checked once to have proper bonds, kept as its pair table
+ */
+struct validated_structure {
+    std::vector<int> pairs; //!< Partner of each position in `(` `)` pairs, or -1
+};
+
+/*! \fn first_invalid_nucleotide
+ * \brief Position of the first character of a sequence that is not A, C, G or U (the terminator if there is none)
+ * @file validation.cpp
+ */
+size_t first_invalid_nucleotide(const char* sequence);
+
+/*! \fn first_invalid_nucleotide
+ * \brief Position of the first character of a view that is not A, C, G or U (the length if there is none)
+ * @file validation.cpp
+ */
+size_t first_invalid_nucleotide(const char* sequence, size_t length);
+
+/*! \fn make_pair_table
+ * \brief Validate a dot-bracket structure in one pass, keeping the partner of each position
+ * @file validation.cpp
+ */
+R_STATUS make_pair_table(const char* structure, /*out*/ std::vector<int>& pairs);
+
+/*! \fn make_pair_table
+ * \brief Validate a dot-bracket view of a given length in one pass, keeping the partner of each position
+ * @file validation.cpp
+ */
+R_STATUS make_pair_table(const char* structure, size_t length, /*out*/ std::vector<int>& pairs);
+
+/*! \fn keep_bond_pairs
+ * \brief Drop the pseudoknot pairs of a pair table, leaving only `(` `)` pairs
+ * @file validation.cpp
+ */
+void keep_bond_pairs(const char* structure, std::vector<int>& pairs);
+
+}